@@ -15,6 +15,10 @@ elseif(MSVC)
     add_definitions(-D_CRT_SECURE_NO_WARNINGS=1)
 endif()
 
+# check for C++20 coroutine support, used by the (optional) coroutine
+# unit tests and benchmarks only; the library itself stays C++11
+CHECK_CXX_COMPILER_FLAG("-std=c++20" HAS_CXX20)
+
 # check for adding a reference to the pthread lib
 CHECK_CXX_COMPILER_FLAG("-pthread" HAS_PTHREAD)
 if(HAS_PTHREAD)
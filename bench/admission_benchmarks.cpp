@@ -0,0 +1,66 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/requests.hpp>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+static size_t node_connections() {
+    auto data = http::client().request(LOCALHOST + "connections?port=8888").data().get();
+    return std::stoul(std::string(data.body.begin(), data.body.end()));
+}
+
+static void run_burst(size_t max_active_requests, size_t max_host_connections) {
+    auto options = http::loop_options();
+    options.max_active_requests  = max_active_requests;
+    options.max_host_connections = max_host_connections;
+    http::client::configure(options);
+
+    auto connections_before = node_connections();
+
+    auto client = http::client();
+    auto start = bench::clock::now();
+    auto reqs = http::requests();
+    for(int i = 0; i < 2000; ++i) { reqs.request(client, LOCALHOST + "HTTP_200_OK"); }
+    reqs.wait_all();
+    auto millis = std::chrono::duration<double, std::milli>(bench::clock::now() - start).count();
+
+    auto queue_wait = bench::samples();
+    for(auto&& r : reqs.reqs) { queue_wait.add_duration(r.queue_wait_time()); }
+
+    auto name = "max_active_requests=" + std::to_string(max_active_requests) + " max_host_connections=" + std::to_string(max_host_connections);
+    bench::report(name + " 2000 GETs", millis, "ms");
+    bench::report("  connections opened", static_cast<double>(node_connections() - connections_before), "");
+    bench::report("  queue wait", queue_wait);
+}
+
+BENCHMARK("admission: a burst of 2000 requests with and without admission control") {
+    run_burst(0, 0);
+    run_burst(0, 32);
+    run_burst(64, 0);
+    run_burst(64, 32);
+
+    http::client::configure(http::loop_options());
+}
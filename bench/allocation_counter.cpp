@@ -0,0 +1,49 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/http-cpp.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// replaces the global allocation functions in order to count the heap
+// allocations; all other forms of operator new/delete forward to these
+
+static std::atomic<size_t> g_allocations(0);
+static std::atomic<size_t> g_allocated_bytes(0);
+
+size_t bench::allocations() { return g_allocations; }
+size_t bench::allocated_bytes() { return g_allocated_bytes; }
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    g_allocated_bytes += size;
+    if(auto ptr = std::malloc(size ? size : 1)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) HTTP_CPP_NOEXCEPT {
+    std::free(ptr);
+}
@@ -0,0 +1,87 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <atomic>
+#include <memory>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+/// Counts the blocks the request arenas take from their upstream.
+struct counting_memory_resource : http::memory_resource {
+    counting_memory_resource() : allocated(0) { }
+    std::atomic<size_t> allocated;
+
+protected:
+    virtual void* do_allocate(size_t bytes, size_t) override { ++allocated; return ::operator new(bytes); }
+    virtual void do_deallocate(void* p, size_t, size_t) override { ::operator delete(p); }
+};
+
+template<typename SETUP>
+static double bench_allocations(std::string const& name, bool future, SETUP setup) {
+    const int count = 200;
+    auto url = LOCALHOST + "HTTP_200_OK";
+
+    auto allocations = bench::samples();
+    for(int i = 0; i < count; ++i) {
+        auto client = http::client();
+        setup(client);
+        client.on_finish = [](http::request) { };
+
+        auto before = bench::allocations();
+        if(future) {
+            client.request(url).data().get();
+        } else {
+            client.request(url).wait();
+        }
+        http::client::wait_for_all();
+        allocations.add(static_cast<double>(bench::allocations() - before));
+    }
+
+    bench::report(name + " heap allocations/request", allocations, "");
+    return allocations.mean();
+}
+
+// The arena only pools the request object and the shared state of its
+// future; everything owned by the request (URL, callbacks, header lists,
+// response headers and body) and libcurl's own allocations stay on the
+// global heap, so the numbers below are reported separately.
+static void bench_arena(std::string const& name, bool future) {
+    auto separate = bench_allocations(name + ", no arena", future, [](http::client& client) { client.request_arena_size = 0; });
+
+    auto upstream = std::make_shared<counting_memory_resource>();
+    auto arena = bench_allocations(name + ", request arena", future, [&](http::client& client) { client.memory_resource = upstream; });
+    auto blocks = static_cast<double>(upstream->allocated.load()) / 200.0;
+
+    bench::report("  pooled by the arena (request object, future)", separate - arena + blocks, "allocations/request");
+    bench::report("  arena blocks", blocks, "allocations/request");
+    bench::report("  not pooled (request data, libcurl)", arena - blocks, "allocations/request");
+}
+
+BENCHMARK("arena: heap allocations per GET request") {
+    bench_arena("wait()", false);
+    bench_arena("data().get()", true);
+}
@@ -0,0 +1,116 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    typedef std::chrono::steady_clock clock;
+
+    /// Returns the number of heap allocations (via operator new) done by
+    /// the whole process so far.
+    size_t allocations();
+
+    /// Returns the number of bytes requested via operator new by the whole
+    /// process so far.
+    size_t allocated_bytes();
+
+    /// Collects a set of samples (e.g., latencies in microseconds) and
+    /// reports their distribution.
+    struct samples {
+        std::vector<double> values;
+
+        void add(double v) { values.push_back(v); }
+
+        template<typename DURATION>
+        void add_duration(DURATION d) {
+            add(std::chrono::duration<double, std::micro>(d).count());
+        }
+
+        double percentile(double p) const {
+            if(values.empty()) { return 0.0; }
+            auto sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+            auto idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+            return sorted[std::min(idx, sorted.size() - 1)];
+        }
+
+        double mean() const {
+            if(values.empty()) { return 0.0; }
+            double sum = 0.0;
+            for(auto v : values) { sum += v; }
+            return sum / values.size();
+        }
+    };
+
+    inline void report(std::string const& name, samples const& s, const char* unit = "us") {
+        std::printf(
+            "%-48s n=%-7zu mean=%10.1f%s p50=%10.1f%s p99=%10.1f%s\n",
+            name.c_str(), s.values.size(),
+            s.mean(), unit, s.percentile(50.0), unit, s.percentile(99.0), unit
+        );
+        std::fflush(stdout);
+    }
+
+    inline void report(std::string const& name, double value, const char* unit) {
+        std::printf("%-48s %12.1f %s\n", name.c_str(), value, unit);
+        std::fflush(stdout);
+    }
+
+    struct benchmark {
+        std::string           name;
+        std::function<void()> run;
+    };
+
+    inline std::vector<benchmark>& registry() {
+        static std::vector<benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    struct registrar {
+        registrar(std::string name, std::function<void()> run) {
+            benchmark b = { std::move(name), std::move(run) };
+            registry().emplace_back(std::move(b));
+        }
+    };
+
+} // namespace bench
+
+#define BENCH_DETAIL_CONCAT2(A, B) A ## B
+#define BENCH_DETAIL_CONCAT(A, B) BENCH_DETAIL_CONCAT2(A, B)
+
+/// Registers a benchmark function; the benchmark is run from the
+/// http_benchmarks driver and prints its own results via bench::report().
+#define BENCHMARK(NAME)                                                                      \
+    static void BENCH_DETAIL_CONCAT(bench_func_, __LINE__)();                                \
+    static bench::registrar BENCH_DETAIL_CONCAT(bench_reg_, __LINE__)(                       \
+        NAME, &BENCH_DETAIL_CONCAT(bench_func_, __LINE__)                                    \
+    );                                                                                       \
+    static void BENCH_DETAIL_CONCAT(bench_func_, __LINE__)()
@@ -0,0 +1,92 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+static std::string temp_filename() {
+    return "http_cpp_body_stream_bench.tmp";
+}
+
+/// Downloads the given URL several times and reports the throughput.
+template<typename DOWNLOAD>
+static void bench_download(std::string const& name, size_t size, DOWNLOAD download) {
+    auto throughput = bench::samples();
+    for(int round = 0; round < 3; ++round) {
+        auto start = bench::clock::now();
+        if(!download()) {
+            std::printf("%s: transfer failed\n", name.c_str());
+            return;
+        }
+        throughput.add((size / (1024.0 * 1024.0)) / std::chrono::duration<double>(bench::clock::now() - start).count());
+    }
+    bench::report(name, throughput, "MiB/s");
+}
+
+BENCHMARK("body_stream: throughput against receive_file") {
+    const size_t size = 1024 * 1024 * 1024;
+    auto url = LOCALHOST + "large?size=" + std::to_string(size);
+    auto filename = temp_filename();
+
+    bench_download("receive_file", size, [&]() {
+        auto client = http::client();
+        client.receive_file = filename;
+        return (client.request(url).result().error_code == http::HTTP_ERROR_OK);
+    });
+
+    for(size_t buffer_size : { size_t(256 * 1024), size_t(4 * 1024 * 1024) }) {
+        auto suffix = " (" + std::to_string(buffer_size / 1024) + " KiB buffer)";
+
+        bench_download("body_stream into a file" + suffix, size, [&]() {
+            auto client = http::client();
+            client.body_stream_size = buffer_size;
+            auto req = client.request(url);
+            auto stream = req.stream();
+            auto file = std::shared_ptr<FILE>(std::fopen(filename.c_str(), "wb"), std::fclose);
+            std::vector<char> chunk(64 * 1024);
+            while(auto n = stream.read(chunk.data(), chunk.size())) {
+                std::fwrite(chunk.data(), 1, n, file.get());
+            }
+            return (req.result().error_code == http::HTTP_ERROR_OK);
+        });
+
+        bench_download("body_stream read and discard" + suffix, size, [&]() {
+            auto client = http::client();
+            client.body_stream_size = buffer_size;
+            auto req = client.request(url);
+            auto stream = req.stream();
+            std::vector<char> chunk(64 * 1024);
+            size_t received = 0;
+            while(auto n = stream.read(chunk.data(), chunk.size())) { received += n; }
+            return ((req.result().error_code == http::HTTP_ERROR_OK) && (received == size));
+        });
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,151 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/impl/completion.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("completion: requests/s for tiny responses") {
+    auto url = LOCALHOST + "HTTP_200_OK";
+    const int count = 2000;
+
+    // callback-only users which never touch a future
+    {
+        auto rps = bench::samples();
+        for(int round = 0; round < 5; ++round) {
+            std::atomic<int> done(0);
+            auto client = http::client();
+            auto start = bench::clock::now();
+            for(int i = 0; i < count; ++i) {
+                client.on_finish = [&](http::request) { ++done; };
+                client.request(url);
+            }
+            while(done < count) { std::this_thread::yield(); }
+            rps.add(count / std::chrono::duration<double>(bench::clock::now() - start).count());
+            http::client::wait_for_all();
+        }
+        bench::report("on_finish callbacks requests/s", rps, "");
+    }
+
+    // blocking waits on each request of a batch
+    {
+        auto rps = bench::samples();
+        for(int round = 0; round < 5; ++round) {
+            auto client = http::client();
+            auto start = bench::clock::now();
+            std::vector<http::request> requests;
+            for(int i = 0; i < count; ++i) { requests.push_back(client.request(url)); }
+            for(auto&& r : requests) { r.wait(); }
+            rps.add(count / std::chrono::duration<double>(bench::clock::now() - start).count());
+            requests.clear();
+            http::client::wait_for_all();
+        }
+        bench::report("request::wait() requests/s", rps, "");
+    }
+
+    // sequential request/response round trips
+    {
+        auto rps = bench::samples();
+        auto client = http::client();
+        for(int round = 0; round < 5; ++round) {
+            auto start = bench::clock::now();
+            for(int i = 0; i < 500; ++i) { client.request(url).wait(); }
+            rps.add(500 / std::chrono::duration<double>(bench::clock::now() - start).count());
+        }
+        bench::report("sequential request::wait() requests/s", rps, "");
+    }
+}
+
+BENCHMARK("completion: signaling primitive per request") {
+    const int count = 100000;
+
+    // the former per-request state: two promises and their futures
+    {
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) {
+            std::promise<http::message> message_promise;
+            auto message_future = message_promise.get_future().share();
+            std::promise<void> finished_promise;
+            auto finished_future = finished_promise.get_future();
+            message_promise.set_value(http::message());
+            finished_promise.set_value();
+            message_future.wait();
+            finished_future.wait();
+        }
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("promise + shared_future + promise<void>", ns, "ns/request");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / count, "");
+    }
+
+    // two intrusive completions
+    {
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) {
+            http::impl::completion completed, finished;
+            completed.complete();
+            finished.complete();
+            completed.wait();
+            finished.wait();
+        }
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("http::impl::completion x 2", ns, "ns/request");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / count, "");
+    }
+
+    // a waiting thread getting woken up
+    {
+        const int rounds = 2000;
+        auto start = bench::clock::now();
+        for(int i = 0; i < rounds; ++i) {
+            std::promise<void> p;
+            auto f = p.get_future();
+            std::thread waiter([&]() { f.wait(); });
+            std::this_thread::yield();
+            p.set_value();
+            waiter.join();
+        }
+        auto us = std::chrono::duration<double, std::micro>(bench::clock::now() - start).count() / rounds;
+        bench::report("thread handoff via std::future", us, "us");
+
+        start = bench::clock::now();
+        for(int i = 0; i < rounds; ++i) {
+            http::impl::completion c;
+            std::thread waiter([&]() { c.wait(); });
+            std::this_thread::yield();
+            c.complete();
+            waiter.join();
+        }
+        us = std::chrono::duration<double, std::micro>(bench::clock::now() - start).count() / rounds;
+        bench::report("thread handoff via completion", us, "us");
+    }
+}
@@ -0,0 +1,146 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/completion_queue.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("completion_queue: requests/s for tiny responses") {
+    auto url = LOCALHOST + "HTTP_200_OK";
+    const int count = 2000;
+
+    // waiting on each request's future in turn
+    {
+        auto rps = bench::samples();
+        auto before = bench::allocations();
+        for(int round = 0; round < 5; ++round) {
+            auto client = http::client();
+            auto start = bench::clock::now();
+            std::vector<http::request> requests;
+            for(int i = 0; i < count; ++i) { requests.push_back(client.request(url)); }
+            for(auto&& r : requests) { r.data().get(); }
+            rps.add(count / std::chrono::duration<double>(bench::clock::now() - start).count());
+            requests.clear();
+            http::client::wait_for_all();
+        }
+        bench::report("future::get() requests/s", rps, "");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / (5 * count), "");
+    }
+
+    // on_finish callbacks handing the requests over to a consumer
+    {
+        auto rps = bench::samples();
+        auto before = bench::allocations();
+        for(int round = 0; round < 5; ++round) {
+            std::mutex mutex;
+            std::vector<http::request> finished;
+            finished.reserve(count);
+            std::atomic<int> done(0);
+            auto client = http::client();
+            auto start = bench::clock::now();
+            for(int i = 0; i < count; ++i) {
+                client.on_finish = [&](http::request req) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.push_back(std::move(req));
+                    ++done;
+                };
+                client.request(url);
+            }
+            while(done < count) { std::this_thread::yield(); }
+            rps.add(count / std::chrono::duration<double>(bench::clock::now() - start).count());
+            http::client::wait_for_all();
+        }
+        bench::report("on_finish callback requests/s", rps, "");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / (5 * count), "");
+    }
+
+    // harvesting the finished requests in batches
+    {
+        auto rps = bench::samples();
+        auto before = bench::allocations();
+        auto queue = std::make_shared<http::completion_queue>(4096);
+        std::vector<http::request> finished(64);
+        for(int round = 0; round < 5; ++round) {
+            auto client = http::client();
+            client.completion_queue = queue;
+            auto start = bench::clock::now();
+            for(int i = 0; i < count; ++i) { client.request(url); }
+            for(int done = 0; done < count; ) {
+                done += static_cast<int>(queue->pop_wait_for(finished.data(), finished.size(), std::chrono::seconds(10)));
+            }
+            rps.add(count / std::chrono::duration<double>(bench::clock::now() - start).count());
+            http::client::wait_for_all();
+        }
+        bench::report("completion_queue requests/s", rps, "");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / (5 * count), "");
+    }
+}
+
+BENCHMARK("completion_queue: handoff overhead per completion") {
+    const int count = 200000;
+
+    // a promise/future pair per completion
+    {
+        std::vector<std::future<int>> futures;
+        futures.reserve(count);
+        auto start = bench::clock::now();
+        std::thread producer([&]() {
+            for(int i = 0; i < count; ++i) {
+                std::promise<int> p;
+                futures.push_back(p.get_future());
+                p.set_value(i);
+            }
+        });
+        producer.join();
+        for(auto&& f : futures) { f.get(); }
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("promise/future::get()", ns, "ns/completion");
+    }
+
+    // a producer pushing while a consumer pops batches concurrently
+    {
+        http::completion_queue queue(1024);
+        std::vector<http::request> requests(count);
+        std::vector<http::request> finished(64);
+        auto start = bench::clock::now();
+        std::thread producer([&]() {
+            for(auto&& r : requests) { queue.push(r); }
+        });
+        for(int done = 0; done < count; ) {
+            done += static_cast<int>(queue.pop_wait_for(finished.data(), finished.size(), std::chrono::seconds(10)));
+        }
+        producer.join();
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("completion_queue batches of 64", ns, "ns/completion");
+        bench::report("  overflowed completions", static_cast<double>(queue.overflow_count()), "");
+    }
+}
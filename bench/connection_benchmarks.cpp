@@ -0,0 +1,75 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#if defined(NODE_SERVER_CERT)
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+static const std::string LOCALHOST_TLS = "https://localhost:8890/";
+
+static size_t node_connections(int port) {
+    auto data = http::client().request(LOCALHOST + "connections?port=" + std::to_string(port)).data().get();
+    return std::stoul(std::string(data.body.begin(), data.body.end()));
+}
+
+static void run_repeated_requests(bool share_connections) {
+    auto options = http::loop_options();
+    options.loop_count        = 8;
+    options.policy            = http::HTTP_LOOP_POLICY_ROUND_ROBIN;
+    options.share_connections = share_connections;
+    http::client::configure(options);
+
+    auto client = http::client();
+    client.protocol = http::HTTP_PROTOCOL_1_1;
+    client.ca_file  = NODE_SERVER_CERT;
+
+    auto connections_before = node_connections(8890);
+    auto stats_before = http::client::statistics();
+
+    auto latency = bench::samples();
+    for(int i = 0; i < 400; ++i) {
+        auto start = bench::clock::now();
+        client.request(LOCALHOST_TLS + "HTTP_200_OK").wait();
+        latency.add_duration(bench::clock::now() - start);
+    }
+
+    auto stats = http::client::statistics();
+    auto reused = static_cast<double>(stats.reused_connections - stats_before.reused_connections);
+    auto opened = static_cast<double>(stats.new_connections - stats_before.new_connections);
+
+    auto name = std::string("loops=8 share_connections=") + (share_connections ? "true" : "false");
+    bench::report(name + " GET (https)", latency);
+    bench::report("  TLS handshakes", static_cast<double>(node_connections(8890) - connections_before), "");
+    bench::report("  connection reuse ratio", 100.0 * reused / (reused + opened), "%");
+}
+
+BENCHMARK("connections: repeated requests to one host from 8 loops with and without a shared connection cache") {
+    run_repeated_requests(false);
+    run_repeated_requests(true);
+
+    http::client::configure(http::loop_options());
+}
+
+#endif // defined(NODE_SERVER_CERT)
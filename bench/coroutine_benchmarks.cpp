@@ -0,0 +1,87 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/coroutine.hpp>
+
+#if defined(HTTP_CPP_HAS_COROUTINES)
+
+#include <atomic>
+#include <thread>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+namespace {
+
+    struct detached_task {
+        struct promise_type {
+            detached_task get_return_object() { return detached_task(); }
+            std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+            std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+            void return_void() { }
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    detached_task await_sequential(http::url url, int count, std::atomic<bool>& done) {
+        auto client = http::client();
+        for(int i = 0; i < count; ++i) {
+            auto req = client.request(url);
+            co_await req;
+        }
+        done = true;
+    }
+
+} // namespace
+
+BENCHMARK("coroutine: 100k sequential awaited requests vs. future::get()") {
+    const int count = 100000;
+    auto url = LOCALHOST + "HTTP_200_OK";
+
+    {
+        auto client = http::client();
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) { client.request(url).data().get(); }
+        auto secs = std::chrono::duration<double>(bench::clock::now() - start).count();
+        bench::report("future::get() requests/s", count / secs, "");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / count, "");
+    }
+    http::client::wait_for_all();
+
+    {
+        std::atomic<bool> done(false);
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        await_sequential(url, count, done);
+        while(!done) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+        auto secs = std::chrono::duration<double>(bench::clock::now() - start).count();
+        bench::report("co_await requests/s", count / secs, "");
+        bench::report("  allocations/request", static_cast<double>(bench::allocations() - before) / count, "");
+    }
+    http::client::wait_for_all();
+}
+
+#endif // defined(HTTP_CPP_HAS_COROUTINES)
@@ -0,0 +1,112 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/thread_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+/// Measures the latency of tiny requests while another thread keeps
+/// streaming requests running whose on_receive callback sleeps for
+/// every chunk (e.g., a slow parser).
+static void measure_tail_latency(std::shared_ptr<http::executor> executor, std::string const& name) {
+    std::atomic<bool> stop(false);
+    std::atomic<int> slow_requests(0);
+
+    std::thread slow([&]() {
+        auto client = http::client();
+        client.callback_executor = executor;
+        while(!stop) {
+            client.on_receive = [](http::message msg, http::progress) {
+                if(!msg.body.empty()) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+                return true;
+            };
+            client.request(LOCALHOST + "stream").wait();
+            ++slow_requests;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto latency = bench::samples();
+    auto client = http::client();
+    for(int i = 0; i < 100; ++i) {
+        auto start = bench::clock::now();
+        client.request(LOCALHOST + "HTTP_200_OK").wait();
+        latency.add_duration(bench::clock::now() - start);
+    }
+
+    stop = true;
+    slow.join();
+    http::client::wait_for_all();
+
+    bench::report(name, latency);
+    bench::report("  slow streaming requests", static_cast<double>(slow_requests), "");
+}
+
+BENCHMARK("executor: latency of requests next to a slow on_receive callback") {
+    // a baseline without any slow callbacks
+    {
+        auto latency = bench::samples();
+        auto client = http::client();
+        for(int i = 0; i < 100; ++i) {
+            auto start = bench::clock::now();
+            client.request(LOCALHOST + "HTTP_200_OK").wait();
+            latency.add_duration(bench::clock::now() - start);
+        }
+        bench::report("no slow callbacks", latency);
+    }
+
+    measure_tail_latency(nullptr, "callbacks on the worker thread");
+    measure_tail_latency(std::make_shared<http::thread_pool>(2), "callbacks on a thread_pool");
+}
+
+BENCHMARK("executor: posting tasks") {
+    const int count = 200000;
+
+    auto pool = std::make_shared<http::thread_pool>(2);
+    {
+        std::atomic<int> done(0);
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) { pool->post([&]() { ++done; }); }
+        while(done < count) { std::this_thread::yield(); }
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("thread_pool::post()", ns, "ns/task");
+        bench::report("  stolen tasks", static_cast<double>(pool->steal_count()), "");
+    }
+
+    {
+        http::strand strand(pool);
+        std::atomic<int> done(0);
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) { strand.post([&]() { ++done; }); }
+        while(done < count) { std::this_thread::yield(); }
+        auto ns = std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count;
+        bench::report("strand::post()", ns, "ns/task");
+    }
+}
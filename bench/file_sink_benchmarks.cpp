@@ -0,0 +1,109 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+/// Runs concurrent downloads into receive files in the given directory
+/// and measures their throughput as well as the latency of unrelated
+/// tiny requests on the same worker loop meanwhile.
+static void bench_receive_files(std::string const& dir, size_t count, size_t size, http::file_sink_options const& options, std::string const& name) {
+    auto url = LOCALHOST + "large?size=" + std::to_string(size);
+
+    std::atomic<bool> downloading(true);
+    auto latency = bench::samples();
+    std::thread probe([&]() {
+        auto client = http::client();
+        while(downloading) {
+            auto start = bench::clock::now();
+            client.request(LOCALHOST + "HTTP_200_OK").wait();
+            latency.add_duration(bench::clock::now() - start);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    auto client = http::client();
+    client.receive_file_options = options;
+    auto start = bench::clock::now();
+    std::vector<http::request> requests;
+    for(size_t i = 0; i < count; ++i) {
+        client.receive_file = dir + "/http_cpp_file_sink_bench_" + std::to_string(i) + ".tmp";
+        requests.push_back(client.request(url));
+    }
+    auto ok = true;
+    for(auto&& r : requests) { ok = ((r.result().error_code == http::HTTP_ERROR_OK) && ok); }
+    auto seconds = std::chrono::duration<double>(bench::clock::now() - start).count();
+
+    downloading = false;
+    probe.join();
+    for(size_t i = 0; i < count; ++i) {
+        std::remove((dir + "/http_cpp_file_sink_bench_" + std::to_string(i) + ".tmp").c_str());
+    }
+
+    if(!ok) {
+        std::printf("%s: transfer failed\n", name.c_str());
+        return;
+    }
+    bench::report(name, (count * size / (1024.0 * 1024.0)) / seconds, "MiB/s");
+    bench::report("  latency of other requests", latency);
+}
+
+static void bench_directory(std::string const& dir, size_t count, size_t size) {
+    std::printf("-- %zu x %zu MiB into %s\n", count, size / (1024 * 1024), dir.c_str());
+
+    auto sync = http::file_sink_options();
+    sync.async = false;
+    bench_receive_files(dir, count, size, sync, "libcurl writing on the worker loop");
+
+    auto async = http::file_sink_options();
+    async.async = true;
+    bench_receive_files(dir, count, size, async, "file sink on writer threads");
+
+    auto tuned = http::file_sink_options();
+    tuned.async = true;
+    tuned.preallocate = true;
+    tuned.direct_io = true;
+    bench_receive_files(dir, count, size, tuned, "file sink + preallocate + O_DIRECT");
+
+    auto durable = http::file_sink_options();
+    durable.async = true;
+    durable.durable = true;
+    bench_receive_files(dir, count, size, durable, "file sink + fdatasync");
+}
+
+BENCHMARK("file_sink: concurrent downloads into receive files") {
+    bench_directory("/dev/shm", 4, 256 * 1024 * 1024);
+
+    // e.g., a mount point of a throttled loop device for emulating a slow disk
+    if(auto slow_dir = std::getenv("HTTP_CPP_BENCH_SLOW_DIR")) {
+        bench_directory(slow_dir, 4, 8 * 1024 * 1024);
+    }
+}
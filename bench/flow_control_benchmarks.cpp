@@ -0,0 +1,96 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#   include <unistd.h>
+#endif // defined(__linux__)
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+static double resident_mib() {
+#if defined(__linux__)
+    size_t pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if(statm >> pages >> resident) {
+        return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+    }
+#endif // defined(__linux__)
+    return 0.0;
+}
+
+/// Streams the given number of bytes through an on_receive_view callback
+/// on a thread pool which checksums the data and sleeps 1 ms per MiB,
+/// i.e., a consumer which is slower than the local network.
+static void stream_through_slow_consumer(size_t size, size_t limit, std::string const& name) {
+    auto client = http::client();
+    client.callback_executor = std::make_shared<http::thread_pool>(1);
+    client.receive_buffer_limit = limit;
+
+    auto rss_before = resident_mib();
+    double rss_max = rss_before;
+    size_t received = 0;
+    size_t since_sleep = 0;
+    unsigned char checksum = 0;
+    client.on_receive_view = [&](http::buffer_view data, http::headers const&, http::progress const&) {
+        for(auto c : data) { checksum ^= static_cast<unsigned char>(c); }
+        received += data.size();
+        since_sleep += data.size();
+        if(since_sleep >= 1024 * 1024) {
+            since_sleep = 0;
+            rss_max = std::max(rss_max, resident_mib());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+
+    auto resumed_before = http::client::statistics().resumed_transfers;
+    auto start = bench::clock::now();
+    auto reply = client.request(LOCALHOST + "large?size=" + std::to_string(size)).data().get();
+    auto seconds = std::chrono::duration<double>(bench::clock::now() - start).count();
+    if((reply.error_code != http::HTTP_ERROR_OK) || (received != size)) {
+        std::printf("%s: transfer failed (%s)\n", name.c_str(), reply.error_string.c_str());
+        return;
+    }
+
+    bench::report(name, (size / (1024.0 * 1024.0)) / seconds, "MiB/s");
+    bench::report("  RSS MiB growth", rss_max - rss_before, "");
+    bench::report("  resumed transfers", static_cast<double>(http::client::statistics().resumed_transfers - resumed_before), "");
+}
+
+BENCHMARK("flow_control: streaming through a slow consumer") {
+    const size_t GiB = 1024 * 1024 * 1024;
+    // the unbounded run last since the freed memory might stay resident
+    stream_through_slow_consumer(10 * GiB, 4 * 1024 * 1024, "10 GiB with 4 MiB receive_buffer_limit");
+    stream_through_slow_consumer(1 * GiB, 4 * 1024 * 1024, "1 GiB with 4 MiB receive_buffer_limit");
+    stream_through_slow_consumer(1 * GiB, 0, "1 GiB without receive_buffer_limit");
+}
@@ -0,0 +1,121 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/headers.hpp>
+#include <http-cpp/utils.hpp>
+
+#include <map>
+#include <vector>
+
+// the header lines of a typical 20 field response
+static const char* const RESPONSE_LINES[] = {
+    "Date: Sat, 17 Oct 2026 10:00:00 GMT",
+    "Content-Type: application/json; charset=utf-8",
+    "Content-Length: 1234",
+    "Connection: keep-alive",
+    "Server: nginx/1.25.3",
+    "Cache-Control: private, max-age=0, no-cache",
+    "ETag: \"5d8c72a5edda8d6a\"",
+    "Last-Modified: Fri, 16 Oct 2026 09:00:00 GMT",
+    "Vary: Accept-Encoding, Origin",
+    "Content-Encoding: gzip",
+    "Strict-Transport-Security: max-age=31536000; includeSubDomains",
+    "X-Content-Type-Options: nosniff",
+    "X-Frame-Options: DENY",
+    "X-Request-Id: 8f14e45f-ceea-467a-9a36-dedd4bea2543",
+    "Access-Control-Allow-Origin: *",
+    "Set-Cookie: session=abcdef0123456789; Path=/; HttpOnly",
+    "Via: 1.1 varnish",
+    "Age: 12",
+    "X-Cache: HIT",
+    "X-Served-By: cache-fra-1234",
+};
+static const size_t LINE_COUNT = sizeof(RESPONSE_LINES) / sizeof(RESPONSE_LINES[0]);
+
+static const char* const LOOKUPS[] = { "content-type", "content-length", "etag", "x-request-id", "x-missing" };
+
+// the former std::map based parsing as the baseline
+static std::map<std::string, std::string> parse_map(std::vector<std::string> const& lines) {
+    std::map<std::string, std::string> result;
+    for(auto&& line : lines) {
+        auto str = std::string(line.data(), line.data() + line.size());
+        auto pos = str.find(": ");
+        if(pos != str.npos) {
+            auto key = http::to_lower(str.substr(0, pos));
+            auto value = str.substr(pos + 2);
+            result[std::move(key)] = std::move(value);
+        }
+    }
+    return result;
+}
+
+template<typename PARSE, typename LOOKUP>
+static void bench_headers(std::string const& name, PARSE parse, LOOKUP lookup) {
+    const int rounds = 20;
+    const int count = 10000;
+
+    std::vector<std::string> lines(RESPONSE_LINES, RESPONSE_LINES + LINE_COUNT);
+
+    auto parse_ns = bench::samples();
+    auto lookup_ns = bench::samples();
+    auto allocations = bench::samples();
+    size_t found = 0;
+    for(int r = 0; r < rounds; ++r) {
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        for(int i = 0; i < count; ++i) {
+            auto h = parse(lines);
+            found += h.size();
+        }
+        parse_ns.add(std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count);
+        allocations.add(static_cast<double>(bench::allocations() - before) / count);
+
+        auto h = parse(lines);
+        start = bench::clock::now();
+        for(int i = 0; i < count; ++i) {
+            for(auto key : LOOKUPS) { found += lookup(h, key); }
+        }
+        lookup_ns.add(std::chrono::duration<double, std::nano>(bench::clock::now() - start).count() / count);
+    }
+
+    bench::report(name + " parse 20 fields", parse_ns, "ns");
+    bench::report("  allocations/response", allocations, "");
+    bench::report("  5 lookups", lookup_ns, "ns");
+    if(found == 0) { bench::report("  (nothing found)", 0.0, ""); }
+}
+
+BENCHMARK("headers: parsing and looking up a 20 field response") {
+    bench_headers("std::map", parse_map, [](std::map<std::string, std::string> const& h, const char* key) {
+        // the former lookups needed an exact lower case key
+        return h.count(key);
+    });
+    bench_headers("http::headers", [](std::vector<std::string> const& lines) {
+        http::headers h;
+        for(auto&& line : lines) { h.parse_line(line); }
+        return h;
+    }, [](http::headers const& h, const char* key) {
+        return h.count(key);
+    });
+}
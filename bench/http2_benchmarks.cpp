@@ -0,0 +1,68 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/requests.hpp>
+
+#if defined(NODE_SERVER_CERT)
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+static const std::string LOCALHOST_TLS = "https://localhost:8890/";
+
+static size_t node_connections(int port) {
+    auto data = http::client().request(LOCALHOST + "connections?port=" + std::to_string(port)).data().get();
+    return std::stoul(std::string(data.body.begin(), data.body.end()));
+}
+
+static void run_parallel_gets(std::string const& name, http::protocol_version protocol, bool multiplex) {
+    auto options = http::loop_options();
+    options.multiplex = multiplex;
+    options.max_concurrent_streams = 1000; // the local server allows up to 1000 streams
+    http::client::configure(options);
+
+    auto client = http::client();
+    client.protocol  = protocol;
+    client.pipe_wait = multiplex;
+    client.ca_file   = NODE_SERVER_CERT;
+
+    auto connections_before = node_connections(8890);
+
+    auto start = bench::clock::now();
+    auto reqs = http::requests();
+    for(int i = 0; i < 1000; ++i) { reqs.request(client, LOCALHOST_TLS + "HTTP_200_OK"); }
+    reqs.wait_all();
+    auto millis = std::chrono::duration<double, std::milli>(bench::clock::now() - start).count();
+
+    bench::report(name + " 1000 parallel GETs", millis, "ms");
+    bench::report("  connections opened", static_cast<double>(node_connections(8890) - connections_before), "");
+}
+
+BENCHMARK("http2: 1000 parallel small GETs via HTTP/1.1 and multiplexed HTTP/2") {
+    run_parallel_gets("HTTP/1.1",           http::HTTP_PROTOCOL_1_1,   false);
+    run_parallel_gets("HTTP/2 multiplexed", http::HTTP_PROTOCOL_2_TLS, true);
+
+    http::client::configure(http::loop_options());
+}
+
+#endif // defined(NODE_SERVER_CERT)
@@ -0,0 +1,61 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("loopback latency: sequential GET") {
+    auto url = LOCALHOST + "HTTP_200_OK";
+    auto client = http::client();
+
+    // warm up the connection cache
+    for(int i = 0; i < 10; ++i) { client.request(url).data().get(); }
+
+    auto latency = bench::samples();
+    for(int i = 0; i < 500; ++i) {
+        auto start = bench::clock::now();
+        client.request(url).data().get();
+        latency.add_duration(bench::clock::now() - start);
+    }
+
+    bench::report("sequential GET /HTTP_200_OK", latency);
+}
+
+BENCHMARK("loopback latency: 8 concurrent GETs") {
+    auto url = LOCALHOST + "HTTP_200_OK";
+    auto client = http::client();
+
+    auto latency = bench::samples();
+    for(int i = 0; i < 100; ++i) {
+        auto start = bench::clock::now();
+        std::vector<http::request> reqs;
+        for(int j = 0; j < 8; ++j) { reqs.emplace_back(client.request(url)); }
+        for(auto&& r : reqs) { r.data().get(); }
+        latency.add_duration(bench::clock::now() - start);
+    }
+
+    bench::report("batch of 8 GET /HTTP_200_OK", latency);
+}
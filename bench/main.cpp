@@ -0,0 +1,52 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+#include "../test/start_node_server.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    // an optional argument selects the benchmarks to run by a sub-string match
+    auto filter = std::string((argc > 1) ? argv[1] : "");
+
+    // start the dummy node.js server
+    auto node_server = start_node_server();
+
+    for(auto&& b : bench::registry()) {
+        if(!filter.empty() && (b.name.find(filter) == b.name.npos)) { continue; }
+
+        std::cout << "== " << b.name << std::endl;
+        b.run();
+    }
+
+    // shutdown the node.js server via a final HTTP GET call
+    http::client::cancel_all();
+    node_server = nullptr;
+    http::client::wait_for_all();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <thread>
+
+#if !defined(WIN32)
+#   include <sys/resource.h>
+#endif // !defined(WIN32)
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+#if !defined(WIN32)
+
+static double cpu_time_ms() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+static size_t max_open_connections() {
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    return ((limit.rlim_cur > 256) ? static_cast<size_t>(limit.rlim_cur - 256) : 0);
+}
+
+static void run_idle_connections(http::loop_engine engine, const char* engine_name) {
+    auto options = http::loop_options();
+    options.engine = engine;
+    http::client::configure(options);
+
+    const size_t counts[] = { 100, 1000, 5000, 10000, 20000 };
+    const auto max_count = max_open_connections();
+
+    for(auto count : counts) {
+        if(count > max_count) {
+            bench::report(std::string(engine_name) + ": skipped (fd limit) idle=" + std::to_string(count), 0.0, "");
+            continue;
+        }
+
+        auto client = http::client();
+        client.connect_timeout = 60;
+        for(size_t i = 0; i < count; ++i) { client.request(LOCALHOST + "long_poll"); }
+
+        // give the connections some time to get established
+        std::this_thread::sleep_for(std::chrono::milliseconds(500 + count / 5));
+
+        auto latency = bench::samples();
+        auto cpu_start = cpu_time_ms();
+        auto wall_start = bench::clock::now();
+        while(bench::clock::now() - wall_start < std::chrono::seconds(1)) {
+            auto start = bench::clock::now();
+            client.request(LOCALHOST + "HTTP_200_OK").data().get();
+            latency.add_duration(bench::clock::now() - start);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        auto cpu_ms = cpu_time_ms() - cpu_start;
+        auto wall_ms = std::chrono::duration<double, std::milli>(bench::clock::now() - wall_start).count();
+
+        auto name = std::string(engine_name) + ": idle=" + std::to_string(count);
+        bench::report(name + " probe latency", latency);
+        bench::report(name + " cpu load", 100.0 * cpu_ms / wall_ms, "%");
+
+        http::client::cancel_all();
+    }
+
+    http::client::configure(http::loop_options());
+}
+
+BENCHMARK("scaling: idle connections with the poll engine") {
+    run_idle_connections(http::HTTP_LOOP_ENGINE_POLL, "poll");
+}
+
+BENCHMARK("scaling: idle connections with the epoll engine") {
+    run_idle_connections(http::HTTP_LOOP_ENGINE_EPOLL, "epoll");
+}
+
+#endif // !defined(WIN32)
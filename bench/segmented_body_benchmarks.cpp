@@ -0,0 +1,86 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <fstream>
+#include <vector>
+
+#if defined(__linux__)
+#   include <unistd.h>
+#endif // defined(__linux__)
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+/// Returns the resident set size of this process in MiB (0 if unknown).
+static double resident_mib() {
+#if defined(__linux__)
+    size_t pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if(statm >> pages >> resident) {
+        return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+    }
+#endif // defined(__linux__)
+    return 0.0;
+}
+
+static void bench_concurrent_downloads(bool segmented) {
+    const int rounds = 5;
+    const int parallel = 8;
+    const size_t size = 100 * 1024 * 1024;
+    auto url = LOCALHOST + "large?size=" + std::to_string(size);
+
+    auto throughput = bench::samples();
+    auto rss_loaded = bench::samples();
+    auto rss_released = bench::samples();
+    for(int r = 0; r < rounds; ++r) {
+        auto client = http::client();
+        client.max_body_reserve = 0; // compare plain growth vs. segments
+        client.segmented_body = segmented;
+
+        auto start = bench::clock::now();
+        std::vector<http::request> requests;
+        for(int i = 0; i < parallel; ++i) { requests.push_back(client.request(url)); }
+        for(auto&& req : requests) { req.wait(); }
+        auto secs = std::chrono::duration<double>(bench::clock::now() - start).count();
+
+        throughput.add(parallel * size / secs / (1024.0 * 1024.0));
+        rss_loaded.add(resident_mib());
+
+        requests.clear();
+        http::client::wait_for_all();
+        rss_released.add(resident_mib());
+    }
+
+    auto name = std::string(segmented ? "segmented" : "contiguous") + " 8 x 100 MiB";
+    bench::report(name + " MiB/s", throughput, "");
+    bench::report("  RSS MiB with bodies held", rss_loaded, "");
+    bench::report("  RSS MiB after release", rss_released, "");
+}
+
+BENCHMARK("segmented body: concurrent 100 MiB downloads") {
+    bench_concurrent_downloads(false);
+    bench_concurrent_downloads(true);
+}
@@ -0,0 +1,61 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+static void run_setup_cost(size_t pool_size, bool use_prototype = false) {
+    auto options = http::loop_options();
+    options.easy_handle_pool_size = pool_size;
+    http::client::configure(options);
+
+    auto url = LOCALHOST + "HTTP_200_OK";
+    auto client = http::client();
+    client.use_prototype = use_prototype;
+    client.headers["x-bench-a"] = "a";
+    client.headers["x-bench-b"] = "b";
+
+    auto setup = bench::samples();
+    for(int i = 0; i < 2000; ++i) {
+        auto start = bench::clock::now();
+        auto req = client.request(url);
+        setup.add_duration(bench::clock::now() - start);
+        req.wait();
+    }
+
+    auto stats = http::client::statistics();
+    bench::report("easy_handle_pool_size=" + std::to_string(pool_size) + (use_prototype ? " use_prototype" : "") + " request() setup", setup);
+    bench::report("  pool hits", static_cast<double>(stats.easy_handle_pool_hits), "");
+    bench::report("  pool misses", static_cast<double>(stats.easy_handle_pool_misses), "");
+}
+
+BENCHMARK("setup: per-request setup cost with and without the easy handle pool or a prototype handle") {
+    run_setup_cost(0);
+    run_setup_cost(64);
+    run_setup_cost(64, true);
+
+    http::client::configure(http::loop_options());
+}
@@ -0,0 +1,144 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("stream: heap allocations for receiving the 200 chunks of /stream") {
+    const int count = 50;
+
+    auto allocations = bench::samples();
+    auto chunks = bench::samples();
+    for(int i = 0; i < count; ++i) {
+        size_t received = 0;
+
+        auto client = http::client();
+        client.on_receive = [&](http::message data, http::progress) { received += !data.body.empty(); return true; };
+
+        auto before = bench::allocations();
+        client.request(LOCALHOST + "stream").wait();
+        http::client::wait_for_all();
+        allocations.add(static_cast<double>(bench::allocations() - before));
+        chunks.add(static_cast<double>(received));
+    }
+
+    bench::report("on_receive GET /stream allocations/request", allocations, "");
+    bench::report("  chunks/request", chunks, "");
+}
+
+BENCHMARK("stream: heap allocations for receiving /stream via on_receive_view") {
+    const int count = 50;
+
+    auto allocations = bench::samples();
+    for(int i = 0; i < count; ++i) {
+        size_t received = 0;
+
+        auto client = http::client();
+        client.on_receive_view = [&](http::buffer_view data, http::headers const&, http::progress const&) { received += data.size(); return true; };
+
+        auto before = bench::allocations();
+        client.request(LOCALHOST + "stream").wait();
+        http::client::wait_for_all();
+        allocations.add(static_cast<double>(bench::allocations() - before));
+    }
+
+    bench::report("on_receive_view GET /stream allocations/request", allocations, "");
+}
+
+BENCHMARK("stream: 1 MiB - 1 GiB downloads into the message body") {
+    const size_t sizes[] = { 1u << 20, 16u << 20, 256u << 20, 1u << 30 };
+    for(auto size : sizes) {
+        auto url = LOCALHOST + "large?size=" + std::to_string(size);
+        const int count = (size >= (256u << 20) ? 3 : 10);
+
+        for(auto reserve : { false, true }) {
+            auto throughput = bench::samples();
+            auto allocations = bench::samples();
+            auto allocated = bench::samples();
+            for(int i = 0; i < count; ++i) {
+                auto client = http::client();
+                client.max_body_reserve = (reserve ? size : 0);
+
+                auto before = bench::allocations();
+                auto before_bytes = bench::allocated_bytes();
+                auto start = bench::clock::now();
+                auto req = client.request(url);
+                req.wait();
+                auto secs = std::chrono::duration<double>(bench::clock::now() - start).count();
+                allocations.add(static_cast<double>(bench::allocations() - before));
+                allocated.add(static_cast<double>(bench::allocated_bytes() - before_bytes) / size);
+                throughput.add(size / secs / (1024.0 * 1024.0));
+            }
+            http::client::wait_for_all();
+
+            auto name = std::to_string(size >> 20) + " MiB " + (reserve ? "reserved" : "grown   ");
+            bench::report(name + " MiB/s", throughput, "");
+            bench::report("  allocations/request", allocations, "");
+            bench::report("  allocated bytes/body byte", allocated, "");
+        }
+    }
+}
+
+template<typename SETUP>
+static void bench_large_download(std::string const& name, SETUP setup) {
+    const int count = 10;
+    const size_t size = 64 * 1024 * 1024;
+    auto url = LOCALHOST + "large?size=" + std::to_string(size);
+
+    auto throughput = bench::samples();
+    auto allocations = bench::samples();
+    for(int i = 0; i < count; ++i) {
+        size_t checksum = 0;
+
+        auto client = http::client();
+        setup(client, checksum);
+
+        auto before = bench::allocations();
+        auto start = bench::clock::now();
+        client.request(url).wait();
+        http::client::wait_for_all();
+        auto secs = std::chrono::duration<double>(bench::clock::now() - start).count();
+        allocations.add(static_cast<double>(bench::allocations() - before));
+        throughput.add(size / secs / (1024.0 * 1024.0));
+    }
+
+    bench::report(name + " MiB/s", throughput, "");
+    bench::report("  allocations/request", allocations, "");
+}
+
+BENCHMARK("stream: parsing a 64 MiB download on the fly") {
+    bench_large_download("on_receive", [](http::client& client, size_t& checksum) {
+        client.on_receive = [&](http::message data, http::progress) {
+            for(auto c : data.body) { checksum += (c == '\n'); }
+            return true;
+        };
+    });
+    bench_large_download("on_receive_view", [](http::client& client, size_t& checksum) {
+        client.on_receive_view = [&](http::buffer_view data, http::headers const&, http::progress const&) {
+            for(auto c : data) { checksum += (c == '\n'); }
+            return true;
+        };
+    });
+}
@@ -0,0 +1,60 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <mutex>
+#include <thread>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("submission: request() latency from 16 producer threads") {
+    const int thread_count = 16;
+    const int requests_per_thread = 200;
+
+    std::mutex mutex;
+    auto latency = bench::samples();
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&]() {
+            auto client = http::client();
+            auto local = bench::samples();
+            std::vector<http::request> reqs;
+            for(int i = 0; i < requests_per_thread; ++i) {
+                auto start = bench::clock::now();
+                reqs.emplace_back(client.request(LOCALHOST + "HTTP_200_OK"));
+                local.add_duration(bench::clock::now() - start);
+            }
+            for(auto&& r : reqs) { r.wait(); }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            latency.values.insert(latency.values.end(), local.values.begin(), local.values.end());
+        });
+    }
+    for(auto&& t : threads) { t.join(); }
+
+    bench::report("client::request() call", latency);
+}
@@ -0,0 +1,61 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/requests.hpp>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+BENCHMARK("throughput: saturate the local server from 1, 2, 4, and 8 loops") {
+    const size_t loop_counts[] = { 1, 2, 4, 8 };
+
+    for(auto loop_count : loop_counts) {
+        auto options = http::loop_options();
+        options.loop_count = loop_count;
+        options.policy = http::HTTP_LOOP_POLICY_ROUND_ROBIN; // a single host => spread by round-robin
+        http::client::configure(options);
+
+        auto client = http::client();
+        size_t completed = 0;
+
+        auto start = bench::clock::now();
+        while(bench::clock::now() - start < std::chrono::seconds(2)) {
+            auto reqs = http::requests();
+            for(int i = 0; i < 64; ++i) { reqs.request(client, LOCALHOST + "HTTP_200_OK"); }
+            reqs.wait_all();
+            completed += reqs.reqs.size();
+        }
+        auto seconds = std::chrono::duration<double>(bench::clock::now() - start).count();
+
+        bench::report("loops=" + std::to_string(loop_count) + " GET /HTTP_200_OK", completed / seconds, "req/s");
+
+        auto stats = http::client::statistics();
+        bench::report("  share lock contention (cookie)",       static_cast<double>(stats.share_lock_contention_cookie),      "");
+        bench::report("  share lock contention (dns)",          static_cast<double>(stats.share_lock_contention_dns),         "");
+        bench::report("  share lock contention (ssl session)",  static_cast<double>(stats.share_lock_contention_ssl_session), "");
+    }
+
+    http::client::configure(http::loop_options());
+}
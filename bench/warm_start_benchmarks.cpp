@@ -0,0 +1,71 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#include "benchmark.hpp"
+
+#include <http-cpp/client.hpp>
+
+#include <cstdio>
+
+#if defined(NODE_SERVER_CERT)
+
+static const std::string LOCALHOST_TLS = "https://localhost:8890/";
+
+static void run_first_request(std::string const& name, std::string const& cache_file) {
+    auto client = http::client();
+    client.ca_file = NODE_SERVER_CERT;
+
+    auto first = bench::samples();
+    for(int i = 0; i < 50; ++i) {
+        // every round simulates a restart with cold caches
+        http::client::configure(http::loop_options());
+        if(!cache_file.empty()) { http::client::load_session_cache(cache_file); }
+
+        auto start = bench::clock::now();
+        client.request(LOCALHOST_TLS + "HTTP_200_OK").wait();
+        first.add_duration(bench::clock::now() - start);
+    }
+
+    bench::report(name + " first request (https)", first);
+}
+
+BENCHMARK("warm start: latency of the first request with and without a preloaded session cache") {
+    auto cache_file = std::string("bench_session_cache.txt");
+
+    // fill the caches and write them out
+    auto options = http::loop_options();
+    options.record_session_hosts = true;
+    http::client::configure(options);
+    auto client = http::client();
+    client.ca_file = NODE_SERVER_CERT;
+    client.request(LOCALHOST_TLS + "HTTP_200_OK").wait();
+    http::client::wait_for_all();
+    http::client::save_session_cache(cache_file);
+
+    run_first_request("cold", "");
+    run_first_request("warm", cache_file);
+
+    std::remove(cache_file.c_str());
+    http::client::configure(http::loop_options());
+}
+
+#endif // defined(NODE_SERVER_CERT)
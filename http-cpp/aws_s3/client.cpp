@@ -26,6 +26,7 @@
 
 #include <ctime>
 #include <cstring>
+#include <map>
 
 namespace {
 
@@ -64,14 +65,20 @@ http::request http::aws_s3::client::request(
     std::string contentMD5;
     std::string contentType;
 
-    std::string canonicalizedAmzHeaders;
+    // the amz headers need to be sorted by their (lower case) names
+    std::map<std::string, std::string> amzHeaders;
     for(auto&& header : headers) {
-        const auto key = http::to_lower(header.first);
+        const auto key = http::to_lower(header.first.str());
         if(starts_with(key.c_str(), "x-amz-")) {
-            canonicalizedAmzHeaders += key + ":" + header.second + "\n";
+            amzHeaders[key] = header.second.str();
         }
     }
 
+    std::string canonicalizedAmzHeaders;
+    for(auto&& header : amzHeaders) {
+        canonicalizedAmzHeaders += header.first + ":" + header.second + "\n";
+    }
+
     const auto canonicalizedResource = url.substr(std::strlen(isHttps ? HTTPS_PREFIX : HTTP_PREFIX) - 1);
 
     const auto stringToSign = 
@@ -0,0 +1,65 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./body_stream.hpp"
+
+#include "./impl/body_stream_buffer.hpp"
+
+http::body_stream::body_stream() { }
+
+http::body_stream::body_stream(std::shared_ptr<http::impl::body_stream_buffer> buffer, std::shared_ptr<void> reader) :
+    m_buffer(std::move(buffer)),
+    m_reader(std::move(reader))
+{ }
+
+bool http::body_stream::valid() const {
+    return static_cast<bool>(m_buffer);
+}
+
+size_t http::body_stream::read(void* data, size_t size) {
+    return (m_buffer ? m_buffer->read(data, size) : 0);
+}
+
+size_t http::body_stream::read_some(void* data, size_t size) {
+    return (m_buffer ? m_buffer->read_some(data, size) : 0);
+}
+
+size_t http::body_stream::read_until(void* data, size_t size, std::chrono::steady_clock::time_point timeout_time) {
+    return (m_buffer ? m_buffer->read_until(data, size, timeout_time) : 0);
+}
+
+void http::body_stream::async_read(void* data, size_t size, std::function<void(size_t)> handler) {
+    if(m_buffer) {
+        m_buffer->async_read(data, size, std::move(handler));
+    } else {
+        handler(0);
+    }
+}
+
+size_t http::body_stream::available() const {
+    return (m_buffer ? m_buffer->available() : 0);
+}
+
+bool http::body_stream::eof() const {
+    return (m_buffer ? m_buffer->eof() : true);
+}
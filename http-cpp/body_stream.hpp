@@ -0,0 +1,102 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    namespace impl { struct body_stream_buffer; }
+
+    /// A reader for the body of a running request, obtained via
+    /// http::request::stream() (see http::client::body_stream_size). The
+    /// worker loop fills a bounded ring buffer which gets drained by the
+    /// read methods; the transfer gets paused while the buffer is full,
+    /// so that arbitrarily large bodies can be consumed with a fixed
+    /// amount of memory. Once the end of the body has been reached the
+    /// request result tells whether the transfer succeeded. Copies of a
+    /// body_stream refer to the same reader; once the last of them is
+    /// gone the remaining body data gets discarded.
+    struct HTTP_API body_stream {
+        /// An invalid reader which reports the end of the body right away.
+        body_stream();
+
+        /// Used by http::request::stream().
+        body_stream(std::shared_ptr<http::impl::body_stream_buffer> buffer, std::shared_ptr<void> reader);
+
+        bool valid() const;
+
+        /// Waits for data and copies up to size bytes of it into the given
+        /// buffer; returns 0 only at the end of the body.
+        size_t read(void* data, size_t size);
+
+        /// Like read() but does not block; returns 0 if no data is
+        /// available right now (see eof()).
+        size_t read_some(void* data, size_t size);
+
+        /// Like read() but waits for data using the given timeout duration;
+        /// returns 0 at the end of the body or on a timeout (see eof()).
+        template<typename DURATION>
+        inline size_t read_for(void* data, size_t size, DURATION const& duration) {
+            return read_until(data, size, std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration));
+        }
+
+        /// Like read() but waits for data using the given absolute timeout
+        /// time; returns 0 at the end of the body or on a timeout (see eof()).
+        size_t read_until(void* data, size_t size, std::chrono::steady_clock::time_point timeout_time);
+
+        /// Reads up to size bytes into the given buffer (which needs to stay
+        /// valid until the handler gets called) and calls the handler with
+        /// the number of bytes read, 0 at the end of the body. The handler
+        /// gets called either right away or from the context of the worker
+        /// thread, so it should return as fast as possible; it can start the
+        /// next asynchronous read. Only one asynchronous read can be pending.
+        void async_read(void* data, size_t size, std::function<void(size_t)> handler);
+
+        /// Returns the number of bytes which can be read without blocking.
+        size_t available() const;
+
+        /// Returns whether the complete body has been read.
+        bool eof() const;
+
+    private:
+        std::shared_ptr<http::impl::body_stream_buffer> m_buffer;
+        std::shared_ptr<void>                           m_reader;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
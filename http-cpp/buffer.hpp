@@ -0,0 +1,78 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace http {
+
+    typedef std::string buffer;
+
+    /// A non-owning view onto a contiguous chunk of data; it is only
+    /// valid as long as the viewed data is (e.g., during the callback
+    /// it has been passed to).
+    struct buffer_view {
+        buffer_view() : m_data(nullptr), m_size(0) { }
+        buffer_view(const char* d, size_t s) : m_data(d), m_size(s) { }
+        buffer_view(const char* s) : m_data(s), m_size(s ? std::strlen(s) : 0) { }
+        buffer_view(http::buffer const& b) : m_data(b.data()), m_size(b.size()) { }
+
+        const char* data()  const { return m_data; }
+        size_t      size()  const { return m_size; }
+        bool        empty() const { return (m_size == 0); }
+
+        const char* begin() const { return m_data; }
+        const char* end()   const { return m_data + m_size; }
+
+        /// Copies the viewed data into an owning buffer.
+        http::buffer to_buffer() const { return http::buffer(m_data, m_size); }
+        http::buffer str() const { return to_buffer(); }
+        operator http::buffer() const { return to_buffer(); }
+
+    private:
+        const char* m_data;
+        size_t      m_size;
+    };
+
+    // non-member functions, so that types converting to a buffer_view
+    // (e.g., http::headers::value_ref) can use them as well
+
+    inline bool operator==(buffer_view const& lhs, buffer_view const& rhs) {
+        return ((lhs.size() == rhs.size()) && (lhs.empty() || (std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0)));
+    }
+
+    inline bool operator!=(buffer_view const& lhs, buffer_view const& rhs) {
+        return !(lhs == rhs);
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, buffer_view const& v) {
+        return out.write(v.data(), static_cast<std::streamsize>(v.size()));
+    }
+
+} // namespace http
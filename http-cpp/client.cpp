@@ -22,15 +22,21 @@
 //
 
 #include "./client.hpp"
+#include "./thread_pool.hpp"
 #include "./utils.hpp"
 
+#include "./impl/body_stream_buffer.hpp"
 #include "./impl/curl_easy_wrap.hpp"
 #include "./impl/curl_global_init_wrap.hpp"
 #include "./impl/curl_multi_wrap.hpp"
+#include "./impl/completion.hpp"
 #include "./impl/curl_share_wrap.hpp"
+#include "./impl/file_sink.hpp"
+#include "./impl/request_arena.hpp"
 
 #include <cstring>
 #include <cstdio>
+#include <fstream>
 
 #if !defined(_WIN32)
 #   include <sys/stat.h>
@@ -103,23 +109,148 @@ namespace {
         return -1;
     }
 
+    /// Extracts the "scheme://host:port" part of the given URL.
+    static inline std::string url_origin(std::string const& url) {
+        auto scheme_end = url.find("://");
+        auto begin = ((scheme_end == url.npos) ? 0 : scheme_end + 3);
+
+        auto end = url.find_first_of("/?#", begin);
+        if(end == url.npos) { end = url.size(); }
+
+        // skip an optional "user:password@" part
+        auto host_begin = begin;
+        auto at = url.find('@', begin);
+        if(at < end) { host_begin = at + 1; }
+
+        return http::to_lower(url.substr(0, begin) + url.substr(host_begin, end - host_begin));
+    }
+
     struct global_data {
-        void add(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+        global_data() :
+            m_round_robin(0),
+            m_receive_buffered(0)
+        {
+            configure(http::loop_options());
+        }
+
+        /// Selects the loop a new request for the given URL gets assigned to.
+        std::shared_ptr<http::impl::curl_multi_wrap> select(std::string const& url) {
+            assert(!m_loops.empty());
+            if(m_loops.size() == 1) { return m_loops.front(); }
+
+            size_t index = 0;
+            if(m_options.select_loop) {
+                std::vector<size_t> active_requests;
+                for(auto&& l : m_loops) { active_requests.push_back(l->active_count()); }
+                index = m_options.select_loop(url, active_requests);
+            } else {
+                switch(m_options.policy) {
+                    case http::HTTP_LOOP_POLICY_HOST_HASH: {
+                        index = std::hash<std::string>()(url_origin(url));
+                        break;
+                    }
+                    case http::HTTP_LOOP_POLICY_LEAST_LOADED: {
+                        auto min_count = m_loops[0]->active_count();
+                        for(size_t i = 1; i < m_loops.size(); ++i) {
+                            auto count = m_loops[i]->active_count();
+                            if(count < min_count) { min_count = count; index = i; }
+                        }
+                        break;
+                    }
+                    case http::HTTP_LOOP_POLICY_ROUND_ROBIN:
+                    default: {
+                        index = m_round_robin++;
+                        break;
+                    }
+                }
+            }
+
+            return m_loops[index % m_loops.size()];
+        }
+
+        void add(http::impl::curl_multi_wrap* loop, std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+            assert(loop);
             assert(wrap);
-            m_share.add(wrap->handle);
-            m_multi.add(wrap);
+            loop->add(wrap);
         }
 
-        void remove(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+        void remove(http::impl::curl_multi_wrap* loop, std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+            assert(loop);
             assert(wrap);
-            m_multi.remove(wrap);
-            m_share.remove(wrap->handle);
+            loop->remove(wrap);
+        }
+
+        void wait_for_all() {
+            for(auto&& l : m_loops) { l->wait_for_all(); }
+        }
+
+        bool wait_until_all(std::chrono::steady_clock::time_point timeout_time) {
+            for(auto&& l : m_loops) {
+                if(!l->wait_until_all(timeout_time)) { return false; }
+            }
+            return true;
+        }
+
+        void cancel_all() {
+            for(auto&& l : m_loops) { l->cancel_all(); }
+        }
+
+        http::loop_statistics statistics() const {
+            auto stats = http::loop_statistics();
+            for(auto&& l : m_loops) { l->collect(stats); }
+            m_share->collect(stats);
+            return stats;
+        }
+
+        bool save_session_cache(std::string const& filename, std::chrono::seconds dns_ttl) {
+            std::ofstream out(filename.c_str());
+            m_share->save(out, dns_ttl);
+            return static_cast<bool>(out);
+        }
+
+        bool load_session_cache(std::string const& filename) {
+            std::ifstream in(filename.c_str());
+            return (in && m_share->load(in));
+        }
+
+        /// Returns the pool writing the receive files; it gets created on
+        /// first use.
+        std::shared_ptr<http::executor> file_writers() {
+            std::lock_guard<std::mutex> lock(m_file_writers_mutex);
+            if(!m_file_writers) {
+                m_file_writers = std::make_shared<http::thread_pool>(std::max<size_t>(m_options.file_writer_threads, 1));
+            }
+            return m_file_writers;
+        }
+
+        void configure(http::loop_options const& options) {
+            // let the running requests finish on the old loops first
+            wait_for_all();
+            m_loops.clear();
+            {
+                std::lock_guard<std::mutex> lock(m_file_writers_mutex);
+                m_file_writers.reset();
+            }
+
+            // the loops might share their connection cache => a new share
+            m_share.reset(new http::impl::curl_share_wrap(options.share_connections, options.record_session_hosts));
+
+            m_options = options;
+            m_options.loop_count = std::max<size_t>(m_options.loop_count, 1);
+            for(size_t i = 0; i < m_options.loop_count; ++i) {
+                m_loops.push_back(std::make_shared<http::impl::curl_multi_wrap>(m_options, m_share.get()));
+            }
         }
 
     public:
-        http::impl::curl_global_init_wrap   m_init;
-        http::impl::curl_share_wrap         m_share;
-        http::impl::curl_multi_wrap         m_multi;
+        http::impl::curl_global_init_wrap                               m_init;
+        std::unique_ptr<http::impl::curl_share_wrap>                    m_share;
+        http::loop_options                                              m_options;
+        std::vector<std::shared_ptr<http::impl::curl_multi_wrap>>       m_loops; // finished requests only keep weak references
+        std::atomic<size_t>                                             m_round_robin;
+        std::atomic<size_t>                                             m_receive_buffered; // see loop_options::receive_buffer_budget
+        std::mutex                                                      m_file_writers_mutex;
+        std::shared_ptr<http::executor>                                 m_file_writers;
     };
 
     static global_data& global() {
@@ -127,44 +258,153 @@ namespace {
         return data;
     }
 
+    static inline long curl_http_version(http::protocol_version protocol) {
+        switch(protocol) {
+            case http::HTTP_PROTOCOL_1_1:               return CURL_HTTP_VERSION_1_1;
+#if (LIBCURL_VERSION_NUM >= 0x072F00) // >= 7.47.0
+            case http::HTTP_PROTOCOL_2_TLS:             return CURL_HTTP_VERSION_2TLS;
+#endif // (LIBCURL_VERSION_NUM >= 0x072F00)
+#if (LIBCURL_VERSION_NUM >= 0x073100) // >= 7.49.0
+            case http::HTTP_PROTOCOL_2_PRIOR_KNOWLEDGE: return CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+#endif // (LIBCURL_VERSION_NUM >= 0x073100)
+            case http::HTTP_PROTOCOL_DEFAULT:
+            default:                                    return CURL_HTTP_VERSION_NONE;
+        }
+    }
+
+    /// Applies the static configuration of the given client (timeouts,
+    /// encoding, protocol, and headers) to the given easy handle.
+    static void set_client_options(CURL* handle, http::client const& client, curl_slist*& header_list) {
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT,    client.connect_timeout);
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT,           client.request_timeout);
+
+        const auto hdrs = http::to_lower(client.headers);
+        if(!hdrs.count("accept-encoding")) {
+            curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, client.accept_compressed ? "" : nullptr);
+        }
+
+#if (LIBCURL_VERSION_NUM >= 0x072100) // >= 7.33.0
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION,      curl_http_version(client.protocol));
+#endif // (LIBCURL_VERSION_NUM >= 0x072100)
+#if (LIBCURL_VERSION_NUM >= 0x072B00) // >= 7.43.0
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT,          client.pipe_wait ? 1L : 0L);
+#endif // (LIBCURL_VERSION_NUM >= 0x072B00)
+        if(!client.ca_file.empty()) {
+            curl_easy_setopt(handle, CURLOPT_CAINFO,        client.ca_file.c_str());
+        }
+
+        for(auto&& h : hdrs) {
+            std::string combined = h.first.str() + ": " + h.second.str();
+            header_list = curl_slist_append(header_list, combined.c_str());
+        }
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, header_list);
+    }
+
+    /// Creates a promise whose shared state lives in the given request
+    /// arena (if any).
+    template<typename T>
+    std::promise<T> make_promise(http::impl::request_arena* arena) {
+        if(!arena) { return std::promise<T>(); }
+        return std::promise<T>(std::allocator_arg, http::impl::arena_allocator<T>(arena));
+    }
+
 } // namespace
 
+struct http::client::prototype {
+    prototype(http::client const& client) :
+        handle(curl_easy_init()),
+        header_list(nullptr),
+        headers(client.headers),
+        connect_timeout(client.connect_timeout),
+        request_timeout(client.request_timeout),
+        accept_compressed(client.accept_compressed),
+        protocol(client.protocol),
+        pipe_wait(client.pipe_wait),
+        ca_file(client.ca_file)
+    {
+        assert(handle);
+
+        http::impl::curl_easy_wrap::set_default_values(handle);
+        set_client_options(handle, client, header_list);
+    }
+
+    ~prototype() {
+        curl_easy_cleanup(handle);
+        curl_slist_free_all(header_list);
+    }
+
+    /// Checks whether this prototype still reflects the static
+    /// configuration of the given client.
+    bool matches(http::client const& client) const {
+        return
+            (connect_timeout    == client.connect_timeout)      &&
+            (request_timeout    == client.request_timeout)      &&
+            (accept_compressed  == client.accept_compressed)    &&
+            (protocol           == client.protocol)             &&
+            (pipe_wait          == client.pipe_wait)            &&
+            (ca_file            == client.ca_file)              &&
+            (headers            == client.headers);
+    }
+
+public:
+    CURL* const                     handle;
+    curl_slist*                     header_list; // referenced (not copied) by all cloned handles
+
+    // the configuration snapshot this prototype has been built from
+    const http::headers             headers;
+    const size_t                    connect_timeout;
+    const size_t                    request_timeout;
+    const bool                      accept_compressed;
+    const http::protocol_version    protocol;
+    const bool                      pipe_wait;
+    const std::string               ca_file;
+};
+
 
 struct http::request::impl :
     public http::impl::curl_easy_wrap,
     public std::enable_shared_from_this<impl>
 {
     impl(
-        http::client&   client,
-        http::url       url,
-        http::operation op
+        http::client&                   client,
+        http::impl::request_arena*      arena,
+        std::shared_ptr<http::impl::curl_multi_wrap> const& loop,
+        std::shared_ptr<void>           prototype,
+        CURL*                           prototype_handle,
+        http::url                       url,
+        http::operation                 op
     ) :
-        curl_easy_wrap(),
-        m_message_promise(),
-        m_message_future(m_message_promise.get_future().share()),
+        curl_easy_wrap(prototype_handle ? nullptr : loop->easy_pool(), prototype_handle),
+        m_arena(arena),
         m_message_accum(http::HTTP_ERROR_REPORT_PROGRESS, error_buffer, http::HTTP_000_UNKNOWN),
-        finished_future(finished_promise.get_future()),
+        m_has_promise(false),
+        m_message_in_future(false),
+        m_result_referenced(false),
+        m_continuation(nullptr),
+        m_continuation_context(nullptr),
         m_cancel(false),
+        m_loop(loop),
+        m_prototype(std::move(prototype)),
         m_url(std::move(url)),
         m_operation(op),
+        m_max_body_reserve(client.max_body_reserve),
+        m_segmented_body(client.segmented_body),
+        m_receive_buffer_limit(client.receive_buffer_limit),
+        m_receive_buffer_budget(global().m_options.receive_buffer_budget),
+        m_receive_buffered(0),
+        m_receive_paused(false),
         m_send_data_progress(0),
         m_send_file_size(0),
         m_progress_mutex(),
-        m_progress()
+        m_progress(),
+        m_progress_posted(false)
     {
         curl_easy_setopt(handle, CURLOPT_URL,       m_url.c_str());
         curl_easy_setopt(handle, CURLOPT_NOBODY,    0);
 
-        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT,    client.connect_timeout);
-        curl_easy_setopt(handle, CURLOPT_TIMEOUT,           client.request_timeout);
-
-        const auto hdrs = to_lower(client.headers);
-        if(!hdrs.count("accept-encoding")) {
-            curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, client.accept_compressed ? "" : nullptr);
-        }
-
-        for(auto&& h : hdrs) {
-            add_header(h.first, h.second);
+        // a cloned handle already carries the static client configuration
+        if(!prototype_handle) {
+            set_client_options(handle, client, headers);
         }
 
         using std::swap;
@@ -173,35 +413,127 @@ struct http::request::impl :
 
         swap(m_on_progress, client.on_progress);
         swap(m_on_receive,  client.on_receive);
+        swap(m_on_receive_view, client.on_receive_view);
 
         swap(m_on_debug,    client.on_debug);
         if(m_on_debug) {
             curl_easy_setopt(handle, CURLOPT_VERBOSE, 1);
         }
 
-        auto on_finish = client.on_finish;
-        if(on_finish) {
-            m_on_finish = [=]() { auto req = http::request(); req.m_impl = shared_from_this(); on_finish(req); };
-            client.on_finish = nullptr;
+        swap(m_on_finish,   client.on_finish);
+
+        m_completion_queue = client.completion_queue;
+
+        // callbacks on an executor need a strand to keep them in order
+        if(client.callback_executor && (m_on_receive || m_on_receive_view || m_on_progress || m_on_finish)) {
+            m_strand.reset(new http::strand(client.callback_executor));
         }
     }
 
     virtual ~impl() {
-        finished_future.wait();
+        m_finished.wait();
+        if(m_has_promise) { promise().~promise(); }
+    }
+
+    /// Returns the future of the resulting message; it gets created on
+    /// first use only, so that callback-only users never pay for it.
+    std::shared_future<http::message>& data() {
+        std::lock_guard<std::mutex> lock(m_future_mutex);
+        if(!m_message_future.valid()) {
+            auto p = make_promise<http::message>(m_arena);
+            m_message_future = p.get_future().share();
+            if(m_completed.ready()) {
+                // hand the message over to the future unless result()
+                // gave out a reference to it already
+                if(m_result_referenced) {
+                    p.set_value(m_message_accum);
+                } else {
+                    p.set_value(std::move(m_message_accum));
+                    m_message_in_future = true;
+                }
+            } else {
+                ::new(&m_promise_storage) std::promise<http::message>(std::move(p));
+                m_has_promise = true;
+            }
+        }
+        return m_message_future;
+    }
+
+    bool set_continuation(void (*continuation)(void*), void* context) {
+        std::lock_guard<std::mutex> lock(m_future_mutex);
+        if(m_completed.ready()) { return false; }
+        assert(!m_continuation);
+        m_continuation          = continuation;
+        m_continuation_context  = context;
+        return true;
+    }
+
+    /// Waits for the request to finish and returns the resulting message.
+    http::message const& result() {
+        m_completed.wait();
+        std::lock_guard<std::mutex> lock(m_future_mutex);
+        if(m_message_in_future) { return m_message_future.get(); }
+        m_result_referenced = true;
+        return m_message_accum;
+    }
+
+    /// Waits for the request to finish and moves the resulting message
+    /// out unless a future or a result() reference might still see it.
+    http::message take_result() {
+        m_completed.wait();
+        std::lock_guard<std::mutex> lock(m_future_mutex);
+        if(m_message_in_future) { return m_message_future.get(); }
+        if(m_result_referenced) { return m_message_accum; }
+        return std::move(m_message_accum);
     }
 
 public:
-    std::promise<http::message>         m_message_promise;
-    std::shared_future<http::message>   m_message_future;
+    http::impl::request_arena* const    m_arena;
     http::message                       m_message_accum;
+    http::headers                       m_header_block;
+
+    // the resulting message is available via m_message_accum or, if the
+    // future has been requested before, via m_message_future
+    http::impl::completion              m_completed;
+    // finish() has returned, including the on_finish callback
+    http::impl::completion              m_finished;
+
+    std::mutex                          m_future_mutex;
+    std::shared_future<http::message>   m_message_future;
+    std::aligned_storage<sizeof(std::promise<http::message>), alignof(std::promise<http::message>)>::type m_promise_storage;
+    bool                                m_has_promise;
+    bool                                m_message_in_future;
+    bool                                m_result_referenced; // m_message_accum must stay in place
+
+    void (*m_continuation)(void*);
+    void*                               m_continuation_context;
 
-    std::promise<void>  finished_promise;
-    std::future<void>   finished_future;
+    std::promise<http::message>& promise() { return *reinterpret_cast<std::promise<http::message>*>(&m_promise_storage); }
 
     std::atomic<bool>   m_cancel;
 
+    // configure() replaces the loops once all requests have finished, so
+    // a late cancel() or resume() must not reach a destroyed loop
+    std::weak_ptr<http::impl::curl_multi_wrap> const m_loop;
+    std::shared_ptr<void> const        m_prototype; // keeps the header list of the cloned handle alive
+
     http::url       m_url;
     http::operation m_operation;
+    size_t const    m_max_body_reserve;
+    bool const      m_segmented_body;
+
+    // flow control of the received data queued for the callbacks on the
+    // executor; guarded by m_receive_mutex
+    size_t const    m_receive_buffer_limit;
+    size_t const    m_receive_buffer_budget;
+    std::mutex      m_receive_mutex;
+    size_t          m_receive_buffered;
+    bool            m_receive_paused;
+
+    // the ring buffer for a body_stream, if requested; the reader closes
+    // it once it is gone
+    std::shared_ptr<http::impl::body_stream_buffer> m_body_buffer;
+    std::weak_ptr<void>                             m_body_reader;
 
     http::buffer    m_send_data;
     int64_t         m_send_data_progress;
@@ -212,21 +544,61 @@ public:
     http::form_data m_post_form;
 
     std::shared_ptr<FILE> m_receive_file;
+    std::shared_ptr<http::impl::file_sink> m_file_sink;
 
     std::function<bool(http::message, http::progress)>  m_on_receive;
-    std::function<void()>                               m_on_finish;
+    std::function<bool(http::buffer_view, http::headers const&, http::progress const&)> m_on_receive_view;
+    std::function<void(http::request)>                  m_on_finish;
+    std::shared_ptr<http::completion_queue>             m_completion_queue;
+    std::unique_ptr<http::strand>                       m_strand;
     std::function<void(std::string const&)>             m_on_debug;
 
     std::mutex                          m_progress_mutex;
     http::progress                      m_progress;
+    http::headers                       m_progress_headers; // for the pending progress post
+    bool                                m_progress_posted;
     std::function<bool(http::progress)> m_on_progress;
 
 public:
-    virtual bool write(const void* ptr, size_t bytes) override {
-        if(m_cancel) { return true; }
+    virtual size_t write(const void* ptr, size_t bytes) override {
+        if(m_cancel) { return bytes; }
 
         auto data = static_cast<const char*>(ptr);
 
+        if(m_file_sink) {
+            // a failed write to the file aborts the transfer
+            if(m_file_sink->failed()) { return 0; }
+            return (m_file_sink->write(data, bytes) ? bytes : CURL_WRITEFUNC_PAUSE);
+        }
+
+        if(m_body_buffer) {
+            // a full buffer pauses the transfer until the reader caught up
+            return (m_body_buffer->write(data, bytes) ? bytes : CURL_WRITEFUNC_PAUSE);
+        }
+
+        // libcurl delivers the same data again once the transfer got resumed
+        if(m_strand && (m_on_receive_view || m_on_receive) && !acquire_receive_buffer(bytes)) {
+            return CURL_WRITEFUNC_PAUSE;
+        }
+
+        if(m_on_receive_view && m_strand) {
+            // libcurl's buffer needs to be copied for the executor
+            m_strand->post(std::bind(&impl::deliver_view, shared_from_this(), http::buffer(data, data + bytes), m_message_accum.headers, progress()));
+            return bytes;
+        }
+
+        if(m_on_receive_view) {
+            // hand out libcurl's buffer directly without accumulating it
+            auto proceed = m_on_receive_view(http::buffer_view(data, bytes), m_message_accum.headers, progress());
+            if(!proceed) { m_cancel = true; }
+            return bytes;
+        }
+
+        if(m_segmented_body && !m_on_receive) {
+            m_message_accum.segmented_body.append(data, bytes);
+            return bytes;
+        }
+
         // add data to the end of the receive/message buffer
         m_message_accum.body.insert(m_message_accum.body.end(), data, data + bytes);
 
@@ -236,11 +608,15 @@ public:
             m_message_accum.body.clear(); // ensure that the receive/message buffer is in a defined state again
 
             // call the callback and check for cancelation
-            auto proceed = m_on_receive(std::move(msg), progress());
-            if(!proceed) { m_cancel = true; }
+            if(m_strand) {
+                m_strand->post(std::bind(&impl::deliver_receive, shared_from_this(), std::move(msg), progress()));
+            } else {
+                auto proceed = m_on_receive(std::move(msg), progress());
+                if(!proceed) { m_cancel = true; }
+            }
         }
 
-        return true;
+        return bytes;
     }
 
     virtual size_t read(void* ptr, size_t bytes) override {
@@ -276,6 +652,7 @@ public:
         size_t downCur, size_t downTotal, size_t downSpeed,
         size_t upCur,   size_t upTotal,   size_t upSpeed
     ) override {
+        auto post = false;
         {
             std::lock_guard<std::mutex> lock(m_progress_mutex);
             m_progress.downloadCurrentBytes = downCur;
@@ -284,6 +661,19 @@ public:
             m_progress.uploadCurrentBytes   = upCur;
             m_progress.uploadTotalBytes     = upTotal;
             m_progress.uploadSpeed          = upSpeed;
+
+            // a slow executor only sees the latest state: the pending
+            // progress post picks up the snapshot when it runs
+            if(m_strand && (m_on_receive || m_on_progress)) {
+                if(m_on_receive) { m_progress_headers = m_message_accum.headers; }
+                post = !m_progress_posted;
+                m_progress_posted = true;
+            }
+        }
+
+        if(m_strand) {
+            if(post) { m_strand->post(std::bind(&impl::deliver_progress, shared_from_this())); }
+            return !m_cancel;
         }
 
         if(m_on_receive) {
@@ -300,6 +690,88 @@ public:
         return !m_cancel;
     }
 
+    // the deliver_*() methods run the callbacks on the strand; the
+    // remaining chunks of a canceled request get dropped
+
+    void deliver_view(http::buffer& data, http::headers& headers, http::progress& p) {
+        if(!m_cancel) {
+            auto proceed = m_on_receive_view(http::buffer_view(data), headers, p);
+            if(!proceed) { cancel_request(); }
+        }
+        release_receive_buffer(data.size());
+    }
+
+    void deliver_receive(http::message& msg, http::progress& p) {
+        auto bytes = msg.body.size();
+        if(!m_cancel) {
+            auto proceed = m_on_receive(std::move(msg), p);
+            if(!proceed) { cancel_request(); }
+        }
+        release_receive_buffer(bytes);
+    }
+
+    /// Accounts for the given number of received bytes getting queued
+    /// for the callbacks; returns false if the transfer should get paused
+    /// instead. A request can always queue at least one chunk.
+    bool acquire_receive_buffer(size_t bytes) {
+        if((m_receive_buffer_limit == 0) && (m_receive_buffer_budget == 0)) { return true; }
+
+        auto& total = global().m_receive_buffered;
+        std::lock_guard<std::mutex> lock(m_receive_mutex);
+        if(m_receive_buffered > 0) {
+            auto over_limit     = ((m_receive_buffer_limit > 0)  && (m_receive_buffered + bytes > m_receive_buffer_limit));
+            auto over_budget    = ((m_receive_buffer_budget > 0) && (total.load() + bytes > m_receive_buffer_budget));
+            if(over_limit || over_budget) {
+                m_receive_paused = true;
+                return false;
+            }
+        }
+        m_receive_buffered += bytes;
+        total += bytes;
+        return true;
+    }
+
+    /// Releases the given number of consumed bytes and resumes a paused
+    /// transfer once half of its receive buffer is available again.
+    void release_receive_buffer(size_t bytes) {
+        if((m_receive_buffer_limit == 0) && (m_receive_buffer_budget == 0)) { return; }
+
+        auto resume = false;
+        {
+            std::lock_guard<std::mutex> lock(m_receive_mutex);
+            assert(m_receive_buffered >= bytes);
+            m_receive_buffered -= bytes;
+            global().m_receive_buffered -= bytes;
+            if(m_receive_paused && (m_receive_buffered <= m_receive_buffer_limit / 2)) {
+                m_receive_paused = false;
+                resume = true;
+            }
+        }
+        if(resume) { resume_request(); }
+    }
+
+    void deliver_progress() {
+        http::message msg(http::HTTP_ERROR_REPORT_PROGRESS, std::string(), http::HTTP_200_OK);
+        http::progress p;
+        {
+            std::lock_guard<std::mutex> lock(m_progress_mutex);
+            m_progress_posted = false;
+            msg.headers = std::move(m_progress_headers);
+            p = m_progress;
+        }
+
+        if(m_cancel) { return; }
+        auto proceed = true;
+        if(m_on_receive)  { proceed = m_on_receive(std::move(msg), p); }
+        if(m_on_progress) { proceed = (m_on_progress(p) && proceed); }
+        if(!proceed) { cancel_request(); }
+    }
+
+    void finish_and_remove(http::error_code code, http::status status) {
+        finish(code, status);
+        global().remove(m_loop.lock().get(), shared_from_this());
+    }
+
     virtual bool seek(int64_t offset, int origin) override {
         if(m_send_file) {
             switch(origin) {
@@ -331,17 +803,48 @@ public:
         if((bytes > 0) && (data[bytes-1] == '\r')) { --bytes; }
 
         // end of headers found
-        if(bytes == 0) { return; }
+        if(bytes == 0) {
+            if(m_file_sink) {
+                m_file_sink->preallocate(final_content_length());
+            } else {
+                reserve_body();
+            }
+            publish_headers();
+            return;
+        }
 
         // try to extract the key-value pair; if found add it to
-        // the message's headers object
-        auto str = std::string(data, data + bytes);
-        auto pos = str.find(": ");
-        if(pos != str.npos) {
-            auto key = to_lower(str.substr(0, pos)); // make all header keys lower case
-            auto value = str.substr(pos + 2);
-            m_message_accum.headers[std::move(key)] = std::move(value);
+        // the header block currently being received
+        m_header_block.parse_line(http::buffer_view(data, bytes));
+    }
+
+    /// Reserves the body buffer for the announced content length of the
+    /// response (capped by the client's max_body_reserve) so that large
+    /// bodies do not get reallocated and copied repeatedly while growing.
+    void reserve_body() {
+        if(m_on_receive || m_on_receive_view || m_body_buffer || m_segmented_body || (m_max_body_reserve == 0)) { return; }
+
+        auto length = final_content_length();
+        if(length <= 0) { return; }
+
+        auto size = std::min(static_cast<uint64_t>(length), static_cast<uint64_t>(m_max_body_reserve));
+        m_message_accum.body.reserve(m_message_accum.body.size() + static_cast<size_t>(size));
+    }
+
+    /// Makes the completely received header block available as the
+    /// (immutable and shared) headers object of all further messages;
+    /// the blocks of multiple responses (e.g., redirects) get merged.
+    void publish_headers() {
+        if(m_header_block.empty()) { return; }
+
+        if(m_message_accum.headers.empty()) {
+            m_message_accum.headers = std::move(m_header_block);
+        } else {
+            auto merged = m_message_accum.headers;
+            for(auto&& h : m_header_block) { merged.set(h.first, h.second); }
+            m_message_accum.headers = std::move(merged);
         }
+        m_header_block.clear();
     }
 
     virtual void start() {
@@ -349,7 +852,25 @@ public:
         // actually handles the request in the send/receive
         // thread and also ensures that this object gets
         // not destructed until it is finished.
-        global().add(shared_from_this());
+        global().add(m_loop.lock().get(), shared_from_this());
+    }
+
+    /// Returns the announced size of the body of the current response;
+    /// -1 if unknown or for interim responses and followed redirects,
+    /// which carry no final body.
+    int64_t final_content_length() {
+        long code = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &code);
+        if((code < 200) || ((300 <= code) && (code < 400))) { return -1; }
+
+#if (LIBCURL_VERSION_NUM >= 0x073700) // >= 7.55.0
+        curl_off_t length = -1;
+        curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+#else // (LIBCURL_VERSION_NUM >= 0x073700)
+        double length = -1;
+        curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length);
+#endif // (LIBCURL_VERSION_NUM >= 0x073700)
+        return ((length > 0) ? static_cast<int64_t>(length) : -1);
     }
 
     virtual void finish(CURLcode code, int status) override {
@@ -358,13 +879,39 @@ public:
             error = http::HTTP_ERROR_REQUEST_CANCELED;
         }
 
-        finish(error, static_cast<http::status>(status));
+        if(m_file_sink) {
+            // the request finishes once all data has been written
+            auto self = shared_from_this();
+            auto sink = std::move(m_file_sink);
+            sink->close([self, error, status](bool written) {
+                auto e = (((error == http::HTTP_ERROR_OK) && !written) ? http::HTTP_ERROR_WRITE_ERROR : error);
+                self->finish_written(e, static_cast<http::status>(status));
+            });
+            return;
+        }
+
+        finish_written(error, static_cast<http::status>(status));
+    }
+
+    void finish_written(http::error_code error, http::status status) {
+        if(m_strand) {
+            // the final callbacks run on the executor as well; the request
+            // keeps counting as running until they have returned
+            m_strand->post(std::bind(&impl::finish_and_remove, shared_from_this(), error, status));
+            return;
+        }
+
+        finish(error, status);
 
         // remove it from the active requests list again
-        global().remove(shared_from_this());
+        global().remove(m_loop.lock().get(), shared_from_this());
     }
 
     virtual void finish(error_code code, http::status status) {
+        publish_headers(); // a transfer might get aborted within a header block
+
+        if(m_body_buffer) { m_body_buffer->finish(); }
+
         m_message_accum.error_code      = code;
         m_message_accum.error_string    = error_buffer;
         m_message_accum.status          = status;
@@ -379,23 +926,74 @@ public:
         m_send_file.reset();
         m_receive_file.reset();
 
-        // set the final message data so it can be retrieved
-        // with the message-future object in the response object
-        m_message_promise.set_value(std::move(m_message_accum));
+        // publish the final message data, either via an already
+        // requested future or directly from this object
+        void (*continuation)(void*) = nullptr;
+        void* continuation_context  = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_future_mutex);
+            continuation            = m_continuation;
+            continuation_context    = m_continuation_context;
+            if(m_has_promise) {
+                promise().set_value(std::move(m_message_accum));
+                m_message_in_future = true;
+            }
+            m_completed.complete();
+        }
 
         // call an optional continuation callback for this request
         if(m_on_finish) {
-            m_on_finish();
+            auto req = http::request();
+            req.m_impl = shared_from_this();
+            m_on_finish(req);
+        }
+
+        // hand the request over to a bound completion queue
+        if(m_completion_queue) {
+            auto req = http::request();
+            req.m_impl = shared_from_this();
+            auto queue = std::move(m_completion_queue);
+            m_finished.complete();
+            queue->push(std::move(req));
+        } else {
+            // mark this request as finished
+            m_finished.complete();
         }
 
-        // mark this request as finished
-        finished_promise.set_value();
+        // resume an awaiting coroutine or the like
+        if(continuation) {
+            continuation(continuation_context);
+        }
     }
     
     virtual void cancel() override {
         m_cancel = true;
     }
 
+    void cancel_request() {
+        if(m_completed.ready()) { return; }
+        if(auto loop = m_loop.lock()) { loop->cancel(shared_from_this()); }
+    }
+
+    void resume_request() {
+        if(m_completed.ready()) { return; }
+        if(auto loop = m_loop.lock()) { loop->resume(shared_from_this()); }
+    }
+
+    http::body_stream stream() {
+        if(!m_body_buffer) { return http::body_stream(); }
+
+        std::lock_guard<std::mutex> lock(m_future_mutex);
+        auto reader = m_body_reader.lock();
+        if(!reader) {
+            auto buffer = m_body_buffer;
+            reader = std::shared_ptr<void>(static_cast<void*>(nullptr), [buffer](void*) { buffer->close(); });
+            m_body_reader = reader;
+            buffer->open();
+        }
+        return http::body_stream(m_body_buffer, std::move(reader));
+    }
+
     void request() {
         curl_easy_setopt(handle, CURLOPT_HTTPGET, 1);
 
@@ -477,14 +1075,38 @@ public:
 
 };
 
-std::shared_future<http::message>& http::request::data() { return m_impl->m_message_future; }
+std::shared_future<http::message>& http::request::data() { return m_impl->data(); }
+http::message const& http::request::result() { return m_impl->result(); }
+http::message http::request::take_result() { return m_impl->take_result(); }
+bool http::request::ready() const { return m_impl->m_completed.ready(); }
+bool http::request::set_continuation(void (*continuation)(void*), void* context) { return m_impl->set_continuation(continuation, context); }
+void http::request::wait() { m_impl->m_completed.wait(); }
+std::future_status http::request::wait_until(std::chrono::steady_clock::time_point timeout_time) {
+    return (m_impl->m_completed.wait_until(timeout_time) ? std::future_status::ready : std::future_status::timeout);
+}
 http::operation http::request::operation() const { return m_impl->m_operation; }
 http::url http::request::url() const { return m_impl->m_url; }
 http::progress http::request::progress() const { return m_impl->progress(); }
-void http::request::cancel() { m_impl->cancel(); }
-
-
-http::client::client() : connect_timeout(300), request_timeout(0), accept_compressed(true) { }
+size_t http::request::queue_depth() const { return m_impl->queue_depth; }
+std::chrono::steady_clock::duration http::request::queue_wait_time() const { return std::chrono::steady_clock::duration(m_impl->queue_wait); }
+void http::request::cancel() { m_impl->cancel_request(); }
+void http::request::resume() { m_impl->resume_request(); }
+http::body_stream http::request::stream() { return m_impl->stream(); }
+
+
+http::client::client() :
+    connect_timeout(300),
+    request_timeout(0),
+    accept_compressed(true),
+    protocol(http::HTTP_PROTOCOL_DEFAULT),
+    pipe_wait(false),
+    max_body_reserve(64 * 1024 * 1024),
+    segmented_body(false),
+    request_arena_size(2048),
+    use_prototype(false),
+    receive_buffer_limit(4 * 1024 * 1024),
+    body_stream_size(0)
+{ }
 
 http::request http::client::request(
     http::url       url,
@@ -494,9 +1116,39 @@ http::request http::client::request(
 
     auto req = http::request();
 
-    req.m_impl = std::make_shared<http::request::impl>(
-        *this, std::move(url), std::move(op)
-    );
+    auto loop = global().select(url);
+    if(use_prototype) {
+        if(!m_prototype || !m_prototype->matches(*this)) {
+            m_prototype = std::make_shared<prototype>(*this);
+        }
+    } else {
+        m_prototype.reset();
+    }
+
+    auto prototype_handle = (m_prototype ? m_prototype->handle : nullptr);
+    if(request_arena_size > 0) {
+        // the request object and its promise states share a single arena
+        auto arena = http::impl::request_arena::create(request_arena_size, memory_resource);
+        req.m_impl = std::allocate_shared<http::request::impl>(
+            http::impl::arena_allocator<http::request::impl>(arena),
+            *this, arena, loop, m_prototype, prototype_handle, std::move(url), std::move(op)
+        );
+        arena->release();
+    } else {
+        req.m_impl = std::make_shared<http::request::impl>(
+            *this, nullptr, loop, m_prototype, prototype_handle, std::move(url), std::move(op)
+        );
+    }
+
+    if((body_stream_size > 0) && receive_file.empty()) {
+        // libcurl never passes more than CURL_MAX_WRITE_SIZE bytes at once
+        auto buffer = std::make_shared<http::impl::body_stream_buffer>(std::max<size_t>(body_stream_size, CURL_MAX_WRITE_SIZE));
+        auto weak_impl = std::weak_ptr<http::request::impl>(req.m_impl);
+        buffer->on_resume = [weak_impl]() {
+            if(auto impl = weak_impl.lock()) { impl->resume_request(); }
+        };
+        req.m_impl->m_body_buffer = std::move(buffer);
+    }
 
     // try to open send file
     if(!send_file.empty()) {
@@ -509,7 +1161,18 @@ http::request http::client::request(
     }
 
     // try to open send file
-    if(!receive_file.empty()) {
+    if(!receive_file.empty() && receive_file_options.async) {
+        auto sink = http::impl::file_sink::open(receive_file, receive_file_options, global().file_writers());
+        if(!sink) {
+            req.m_impl->finish(HTTP_ERROR_COULDNT_OPEN_RECEIVE_FILE, HTTP_000_UNKNOWN);
+            return req;
+        }
+        auto weak_impl = std::weak_ptr<http::request::impl>(req.m_impl);
+        sink->on_resume = [weak_impl]() {
+            if(auto impl = weak_impl.lock()) { impl->resume_request(); }
+        };
+        req.m_impl->m_file_sink = std::move(sink);
+    } else if(!receive_file.empty()) {
         req.m_impl->m_receive_file = open_file(receive_file, "wb");
         if(!req.m_impl->m_receive_file) {
             req.m_impl->finish(HTTP_ERROR_COULDNT_OPEN_RECEIVE_FILE, HTTP_000_UNKNOWN);
@@ -522,5 +1185,13 @@ http::request http::client::request(
     return req;
 }
 
-void http::client::wait_for_all() { global().m_multi.wait_for_all(); }
-void http::client::cancel_all() { global().m_multi.cancel_all(); }
+void http::client::wait_for_all() { global().wait_for_all(); }
+void http::client::cancel_all() { global().cancel_all(); }
+
+std::future_status http::client::wait_until_all(std::chrono::steady_clock::time_point timeout_time) {
+    return (global().wait_until_all(timeout_time) ? std::future_status::ready : std::future_status::timeout);
+}
+void http::client::configure(http::loop_options const& options) { global().configure(options); }
+http::loop_statistics http::client::statistics() { return global().statistics(); }
+bool http::client::save_session_cache(std::string const& filename, std::chrono::seconds dns_ttl) { return global().save_session_cache(filename, dns_ttl); }
+bool http::client::load_session_cache(std::string const& filename) { return global().load_session_cache(filename); }
@@ -23,7 +23,13 @@
 
 #pragma once
 
+#include "./completion_queue.hpp"
+#include "./executor.hpp"
+#include "./file_sink_options.hpp"
 #include "./form_data.hpp"
+#include "./loop_options.hpp"
+#include "./loop_statistics.hpp"
+#include "./memory_resource.hpp"
 #include "./request.hpp"
 
 #include <cassert>
@@ -36,6 +42,25 @@
 
 namespace http {
 
+    /// The HTTP protocol version requested by a client.
+    enum protocol_version {
+        /// Lets libcurl choose its default version.
+        HTTP_PROTOCOL_DEFAULT,
+
+        /// Enforces HTTP/1.1.
+        HTTP_PROTOCOL_1_1,
+
+        /// Negotiates HTTP/2 via ALPN for https URLs and uses HTTP/1.1
+        /// for plain http URLs. Requires libcurl >= 7.47.0.
+        HTTP_PROTOCOL_2_TLS,
+
+        /// Talks HTTP/2 right away without any upgrade or negotiation,
+        /// also for plain http URLs (h2c); only suited for servers known
+        /// to support it (e.g., internal services). Requires libcurl >=
+        /// 7.49.0.
+        HTTP_PROTOCOL_2_PRIOR_KNOWLEDGE
+    };
+
     struct HTTP_API client {
         virtual ~client() { }
 
@@ -44,7 +69,10 @@ namespace http {
         client();
 
         /// These headers will be added to each request started
-        /// from this client.
+        /// from this client; their names get sent as they have been set.
+        /// Note: http::headers is no longer a sorted std::map; see its
+        /// documentation for the changed value type, iteration order,
+        /// and comparison.
         http::headers headers;
 
         /// If receive_file is specified a file with the given filename
@@ -56,6 +84,12 @@ namespace http {
         /// thrown from the request() method.
         std::string receive_file;
 
+        /// Configures how the received content gets written to the
+        /// receive_file; by default libcurl writes it from the worker
+        /// thread, http::file_sink_options::async moves the writing to a
+        /// separate pool of writer threads.
+        http::file_sink_options receive_file_options;
+
         /// This data buffer will be used for sending data from the client
         /// to the HTTP server. Note that you should not send data with
         /// some specific HTTP request methods such as GET or DELETE.
@@ -94,6 +128,66 @@ namespace http {
         /// some network bandwidth if possible.
         bool accept_compressed;
 
+        /// The HTTP protocol version requested for each request. The
+        /// default value is HTTP_PROTOCOL_DEFAULT. See also
+        /// http::loop_options::multiplex.
+        http::protocol_version protocol;
+
+        /// If pipe_wait is set a new request waits for an existing or
+        /// pending connection to the same host which might be able to
+        /// multiplex it instead of opening a new connection right away.
+        /// Requires libcurl >= 7.43.0. The default value is false.
+        bool pipe_wait;
+
+        /// If ca_file is specified the peer's certificate of https
+        /// requests gets verified against the certificate(s) in the
+        /// given PEM file instead of the default CA bundle of libcurl.
+        std::string ca_file;
+
+        /// Once the headers of a response arrive, the body buffer gets
+        /// reserved for the announced Content-Length up to this number of
+        /// bytes, avoiding repeated reallocations and copies of large
+        /// bodies; larger bodies grow on demand beyond that. The cap
+        /// keeps a server from forcing huge allocations upfront. Set to
+        /// 0 to disable the reservation. The default value is 64 MiB.
+        size_t max_body_reserve;
+
+        /// If segmented_body is set the received data gets stored in
+        /// the segmented_body member of the resulting message (a list of
+        /// pooled fixed-size segments) instead of the contiguous body,
+        /// which avoids any reallocation and copying of large bodies while
+        /// they grow; use http::segmented_buffer::flatten() if a contiguous
+        /// copy is needed after all. The default value is false.
+        bool segmented_body;
+
+        /// The size of the memory block each request allocates its own
+        /// bookkeeping (the request object and the shared state of its
+        /// future, if requested) from; all of it gets released in one
+        /// step once the request and its futures are gone. More blocks of
+        /// this size are added if needed. Set to 0 to allocate each object
+        /// separately. Only this bookkeeping uses the arena: the URL, the
+        /// callbacks, the send data, the header lists, and the received
+        /// headers and body are still allocated from the global heap
+        /// (or by libcurl). The default value is 2048 bytes.
+        size_t request_arena_size;
+
+        /// If a memory_resource is provided the blocks of the per-request
+        /// arenas get allocated from it instead of the global operator
+        /// new; see also http::pmr_memory_resource.
+        std::shared_ptr<http::memory_resource> memory_resource;
+
+        /// If use_prototype is set the static configuration of this
+        /// client (headers, timeouts, accept_compressed, protocol,
+        /// pipe_wait, ca_file, and the TLS
+        /// defaults) gets compiled into a prototype handle once, and
+        /// each new request is just a clone of it plus its per-request
+        /// options; this saves CPU time for clients starting lots of
+        /// similar requests. The prototype is rebuilt automatically
+        /// if the configuration changes. Cloned handles bypass the
+        /// easy handle pool of the worker loops (see loop_options).
+        /// The default value is false.
+        bool use_prototype;
+
         /// If an on_finish callback is provided the callback
         /// will be called immediately after finishing the
         /// request; the provided request object can then be
@@ -104,10 +198,59 @@ namespace http {
         /// callback implementation and the callback should
         /// return as fast as possible since it will block
         /// sending and receiving further data for other requests
-        /// running in parallel. The on_progress member will be
-        /// clear once a request gets started.
+        /// running in parallel. If receive_file_options.async is
+        /// set the callback (as well as the final on_receive call)
+        /// gets called from the writer thread which completed
+        /// writing the receive_file instead of the worker thread; a
+        /// callback_executor takes precedence. The
+        /// on_progress member will be clear once a request gets
+        /// started.
         std::function<void(http::request)> on_finish;
 
+        /// If a completion_queue is provided each finished request gets
+        /// pushed onto it (after a possible on_finish callback has been
+        /// called); this allows for harvesting the completions of lots
+        /// of requests in batches from any thread without waiting on
+        /// each request separately. A single queue can be shared by any
+        /// number of clients.
+        std::shared_ptr<http::completion_queue> completion_queue;
+
+        /// If a callback_executor is provided (e.g., a http::thread_pool)
+        /// the on_receive, on_receive_view, on_progress, and on_finish
+        /// callbacks of a request get run on it instead of the worker
+        /// thread, so that slow callbacks cannot delay the transfers of
+        /// other requests; the callbacks of a single request are still
+        /// called one after the other in their original order. The
+        /// received chunks get copied for on_receive_view in this case
+        /// and returning false from a callback cancels the request
+        /// asynchronously. A request counts as running (see
+        /// wait_for_all()) until its final callbacks have returned. The
+        /// on_debug callback is always called on the worker thread.
+        std::shared_ptr<http::executor> callback_executor;
+
+        /// The maximum number of received bytes a request may have queued
+        /// for its on_receive or on_receive_view callbacks on the
+        /// callback_executor; once the callbacks fall further behind, the
+        /// transfer gets paused (the server is not read from anymore) and
+        /// resumed as soon as half of the queued data got consumed. This
+        /// keeps the memory usage of slow consumers bounded; see also
+        /// http::loop_options::receive_buffer_budget. Set to 0 to disable
+        /// the limit. The default value is 4 MiB.
+        size_t receive_buffer_limit;
+
+        /// If body_stream_size is set the received body does not get
+        /// added to the resulting message (nor passed to on_receive or
+        /// on_receive_view) but gets passed through a ring buffer of this
+        /// size to the reader returned by http::request::stream(); the
+        /// transfer gets paused while the buffer is full, so the body
+        /// needs to be read (or the reader dropped) for the request to
+        /// finish. If the buffer fills up before any reader has been
+        /// obtained, the body gets discarded instead of pausing the
+        /// transfer forever, so stream() should be called right after
+        /// starting the request. Does not apply to a receive_file. The
+        /// default value is 0 (disabled).
+        size_t body_stream_size;
+
         /// If an on_receive callback is provided the callback
         /// will be called each time new data has been received;
         /// the callback will be called from the context of another
@@ -124,6 +267,19 @@ namespace http {
         /// member will be clear once a request gets started.
         std::function<bool(http::message data, http::progress progress)> on_receive;
 
+        /// If an on_receive_view callback is provided the callback will be
+        /// called with a non-owning view onto each chunk of received data
+        /// directly from the receive buffer of libcurl, together with the
+        /// response headers and the current progress; no data gets copied
+        /// or allocated per chunk. The view and the headers reference are
+        /// only valid during the call. The same threading and cancelation
+        /// rules as for on_receive apply. The received data will neither
+        /// be added to the body of the returned message nor be passed to
+        /// an on_receive callback, which still gets called for the final
+        /// message. The on_receive_view member will be clear once a
+        /// request gets started.
+        std::function<bool(http::buffer_view data, http::headers const& headers, http::progress const& progress)> on_receive_view;
+
         /// If an on_progress callback is provided the callback
         /// will be called periodically with the current
         /// progress info; returning "false" from the progress
@@ -156,8 +312,63 @@ namespace http {
             http::operation op = http::OP_GET()
         );
 
+        /// Waits for all running requests to finish.
         static void wait_for_all();
+
+        /// Cancels all running requests and waits for them to finish.
         static void cancel_all();
+
+        /// Waits for all running requests to finish using the given timeout duration.
+        template<typename DURATION>
+        static inline std::future_status wait_for_all(DURATION const& duration) {
+            return wait_until_all(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration));
+        }
+
+        /// Waits for all running requests to finish using the given absolute timeout time.
+        static std::future_status wait_until_all(std::chrono::steady_clock::time_point timeout_time);
+
+        /// Waits for all running requests to finish using the given absolute
+        /// timeout time of an arbitrary clock (e.g., std::chrono::system_clock).
+        template<typename CLOCK, typename DURATION>
+        static inline std::future_status wait_until_all(std::chrono::time_point<CLOCK, DURATION> const& timeout_time) {
+            return wait_for_all(timeout_time - CLOCK::now());
+        }
+
+        /// Replaces the worker loop(s) handling all requests with new
+        /// ones configured by the given options. This waits for all
+        /// running requests to finish first and must not be called
+        /// while other threads are starting new requests.
+        static void configure(http::loop_options const& options);
+
+        /// Returns the counters collected by the current worker loop(s).
+        static http::loop_statistics statistics();
+
+        /// Writes the host addresses used by the finished requests (see
+        /// http::loop_options::record_session_hosts) and, with libcurl >=
+        /// 8.12.0, the cached TLS sessions to the given file; loading it
+        /// via load_session_cache() after a restart lets the first
+        /// requests skip their DNS lookups and full TLS handshakes. The
+        /// host addresses expire after the given time to live. Returns
+        /// false if the file could not be written.
+        static bool save_session_cache(
+            std::string const&      filename,
+            std::chrono::seconds    dns_ttl = std::chrono::seconds(300)
+        );
+
+        /// Preloads the host addresses and TLS sessions from a file written
+        /// by save_session_cache(); expired entries get skipped. Call this
+        /// after configure(), which starts with empty caches again; the
+        /// next request started afterwards adds the host addresses to the
+        /// shared DNS cache, so requests may already be running. Returns
+        /// false if the file could not be read or has an unknown format.
+        static bool load_session_cache(std::string const& filename);
+
+    private:
+        /// The static configuration (headers, timeouts, encoding, TLS
+        /// options) compiled into an easy handle which gets cloned for
+        /// each new request; it is rebuilt once the configuration changes.
+        struct prototype;
+        std::shared_ptr<prototype> m_prototype;
     };
     
 } // namespace http
@@ -0,0 +1,126 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./completion_queue.hpp"
+
+#include "./impl/mpmc_ring.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+struct http::completion_queue::state {
+    explicit state(size_t capacity) :
+        ring(capacity),
+        overflow_size(0),
+        overflow_count(0),
+        sleepers(0)
+    { }
+
+    http::impl::mpmc_ring<http::request> ring;
+
+    // requests not fitting into the ring; only touched if it ran full
+    std::mutex                  overflow_mutex;
+    std::deque<http::request>   overflow;
+    std::atomic<size_t>         overflow_size;
+    std::atomic<size_t>         overflow_count;
+
+    // consumers waiting for requests to arrive
+    std::mutex                  wait_mutex;
+    std::condition_variable     wait_cv;
+    std::atomic<size_t>         sleepers;
+
+    size_t pop(http::request* requests, size_t max) {
+        size_t n = 0;
+        while((n < max) && ring.pop(requests[n])) { ++n; }
+
+        if((n < max) && (overflow_size.load() > 0)) {
+            std::lock_guard<std::mutex> lock(overflow_mutex);
+            while((n < max) && !overflow.empty()) {
+                requests[n++] = std::move(overflow.front());
+                overflow.pop_front();
+                --overflow_size;
+            }
+        }
+
+        return n;
+    }
+
+    bool empty() const {
+        return (ring.empty() && (overflow_size.load() == 0));
+    }
+};
+
+http::completion_queue::completion_queue(size_t capacity) :
+    m_state(new state(capacity))
+{ }
+
+http::completion_queue::~completion_queue() { }
+
+size_t http::completion_queue::pop(http::request* requests, size_t max) {
+    return m_state->pop(requests, max);
+}
+
+size_t http::completion_queue::pop_wait_until(http::request* requests, size_t max, std::chrono::steady_clock::time_point timeout_time) {
+    auto& s = *m_state;
+    for(;;) {
+        auto n = s.pop(requests, max);
+        if((n > 0) || (max == 0)) { return n; }
+
+        std::unique_lock<std::mutex> lock(s.wait_mutex);
+        ++s.sleepers;
+        // pairs with the fence in push(): either push() sees the sleeper
+        // or the predicate below sees the pushed request
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto ready = s.wait_cv.wait_until(lock, timeout_time, [&]() { return !s.empty(); });
+        --s.sleepers;
+        if(!ready) { return 0; }
+    }
+}
+
+size_t http::completion_queue::size() const {
+    return (m_state->ring.size() + m_state->overflow_size.load());
+}
+
+size_t http::completion_queue::overflow_count() const {
+    return m_state->overflow_count.load();
+}
+
+void http::completion_queue::push(http::request req) {
+    auto& s = *m_state;
+    if(!s.ring.push(req)) {
+        std::lock_guard<std::mutex> lock(s.overflow_mutex);
+        s.overflow.push_back(std::move(req));
+        ++s.overflow_size;
+        ++s.overflow_count;
+    }
+
+    // only wake up consumers if there are any waiting; the fence keeps
+    // the check from passing the publishing of the request above
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(s.sleepers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(s.wait_mutex); }
+        s.wait_cv.notify_one();
+    }
+}
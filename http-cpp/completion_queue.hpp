@@ -0,0 +1,88 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./request.hpp"
+
+#include <chrono>
+#include <memory>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    /// A queue of finished requests for harvesting completions in batches
+    /// (see http::client::completion_queue). The finished requests are
+    /// pushed into a bounded lock-free ring by the worker loops; if the
+    /// ring is full they get appended to an overflow list instead, so
+    /// that the worker loops never block. Any number of threads can pop
+    /// from the queue.
+    struct HTTP_API completion_queue {
+        /// The capacity gets rounded up to a power of two.
+        explicit completion_queue(size_t capacity = 1024);
+        ~completion_queue();
+
+        /// Moves up to max finished requests into the given array and
+        /// returns their number; does not block.
+        size_t pop(http::request* requests, size_t max);
+
+        /// Like pop() but waits for at least one finished request using the
+        /// given timeout duration.
+        template<typename DURATION>
+        inline size_t pop_wait_for(http::request* requests, size_t max, DURATION const& duration) {
+            return pop_wait_until(requests, max, std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration));
+        }
+
+        /// Like pop() but waits for at least one finished request using the
+        /// given absolute timeout time.
+        size_t pop_wait_until(http::request* requests, size_t max, std::chrono::steady_clock::time_point timeout_time);
+
+        /// Returns an approximation of the number of queued requests.
+        size_t size() const;
+
+        /// Returns how many requests did not fit into the ring and went
+        /// to the overflow list so far.
+        size_t overflow_count() const;
+
+        /// Adds a finished request; called by the worker loops.
+        void push(http::request req);
+
+    private:
+        struct state;
+        std::unique_ptr<state> m_state;
+
+    private:
+        completion_queue(completion_queue const&); // = delete;
+        completion_queue& operator=(completion_queue const&); // = delete;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
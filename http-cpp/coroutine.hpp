@@ -0,0 +1,131 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./request.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       include <coroutine>
+#       define HTTP_CPP_HAS_COROUTINES
+#   endif
+#endif // defined(__cpp_impl_coroutine) && defined(__has_include)
+
+#if defined(HTTP_CPP_HAS_COROUTINES)
+
+namespace http {
+
+    namespace impl {
+
+        /// Returns the message of an awaited request: a reference to it
+        /// if the awaiter refers to the request, and the moved message
+        /// if the awaiter owns the request.
+        inline http::message const& resume_result(http::request& req) { return req.result(); }
+        inline http::message resume_result(http::request&& req) { return req.take_result(); }
+
+    } // namespace impl
+
+    /// Suspends the awaiting coroutine until the request finished; the
+    /// coroutine gets resumed directly from the finishing worker loop
+    /// thread (see resume_on() for resuming it somewhere else), so it
+    /// should not block. Awaiting does not allocate anything beyond the
+    /// coroutine frame.
+    template<typename REQUEST, typename RESULT>
+    struct request_awaiter {
+        explicit request_awaiter(REQUEST req) : m_request(static_cast<REQUEST&&>(req)) { }
+
+        bool await_ready() const { return m_request.ready(); }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            m_handle = handle;
+            return m_request.set_continuation(&resume, this); // false: finished meanwhile
+        }
+
+        RESULT await_resume() { return impl::resume_result(static_cast<REQUEST&&>(m_request)); }
+
+    private:
+        static void resume(void* self) { static_cast<request_awaiter*>(self)->m_handle.resume(); }
+
+        REQUEST                 m_request;
+        std::coroutine_handle<> m_handle;
+    };
+
+    /// Like request_awaiter but resumes the awaiting coroutine by passing
+    /// its handle (a callable) to EXECUTOR::post(), even if the request
+    /// is already finished.
+    template<typename EXECUTOR, typename REQUEST, typename RESULT>
+    struct request_executor_awaiter {
+        request_executor_awaiter(EXECUTOR& executor, REQUEST req) : m_executor(executor), m_request(static_cast<REQUEST&&>(req)) { }
+
+        bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            m_handle = handle;
+            if(!m_request.set_continuation(&resume, this)) {
+                m_executor.post(m_handle); // already finished
+            }
+        }
+
+        RESULT await_resume() { return impl::resume_result(static_cast<REQUEST&&>(m_request)); }
+
+    private:
+        static void resume(void* self) {
+            auto awaiter = static_cast<request_executor_awaiter*>(self);
+            awaiter->m_executor.post(awaiter->m_handle);
+        }
+
+        EXECUTOR&               m_executor;
+        REQUEST                 m_request;
+        std::coroutine_handle<> m_handle;
+    };
+
+    /// Awaiting a request object results in a reference to its message,
+    /// valid as long as the request object exists.
+    inline request_awaiter<http::request&, http::message const&> operator co_await(http::request& req) {
+        return request_awaiter<http::request&, http::message const&>(req);
+    }
+
+    /// Awaiting a temporary request object (e.g., co_await
+    /// client.request(url)) results in its message, moved out of the
+    /// request without copying the body.
+    inline request_awaiter<http::request, http::message> operator co_await(http::request&& req) {
+        return request_awaiter<http::request, http::message>(static_cast<http::request&&>(req));
+    }
+
+    /// Returns an awaitable for the given request which resumes the
+    /// awaiting coroutine via the given executor (e.g., a
+    /// http::thread_pool) instead of on the worker loop thread.
+    template<typename EXECUTOR>
+    inline request_executor_awaiter<EXECUTOR, http::request&, http::message const&> resume_on(EXECUTOR& executor, http::request& req) {
+        return request_executor_awaiter<EXECUTOR, http::request&, http::message const&>(executor, req);
+    }
+
+    template<typename EXECUTOR>
+    inline request_executor_awaiter<EXECUTOR, http::request, http::message> resume_on(EXECUTOR& executor, http::request&& req) {
+        return request_executor_awaiter<EXECUTOR, http::request, http::message>(executor, static_cast<http::request&&>(req));
+    }
+
+} // namespace http
+
+#endif // defined(HTTP_CPP_HAS_COROUTINES)
@@ -0,0 +1,80 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./executor.hpp"
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+
+http::executor::~executor() { }
+
+struct http::strand::state :
+    public std::enable_shared_from_this<state>
+{
+    explicit state(std::shared_ptr<executor> t) : target(std::move(t)), running(false) { }
+
+    std::shared_ptr<executor>           target;
+    std::mutex                          mutex;
+    std::deque<std::function<void()>>   tasks;
+    bool                                running;
+
+    /// Runs the queued tasks until there are none left; only a single
+    /// drain() call is scheduled at any time.
+    void drain() {
+        for(;;) {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(tasks.empty()) {
+                    running = false;
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+http::strand::strand(std::shared_ptr<executor> target) :
+    m_state(std::make_shared<state>(std::move(target)))
+{
+    assert(m_state->target);
+}
+
+http::strand::~strand() { }
+
+void http::strand::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->tasks.push_back(std::move(task));
+        if(m_state->running) { return; }
+        m_state->running = true;
+    }
+
+    // the scheduled drain() call keeps the state alive
+    auto s = m_state;
+    s->target->post([s]() { s->drain(); });
+}
@@ -0,0 +1,73 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <functional>
+#include <memory>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    /// The interface of an execution context running submitted tasks
+    /// (e.g., http::thread_pool); see http::client::callback_executor.
+    struct HTTP_API executor {
+        virtual ~executor();
+
+        /// Schedules the given task for execution; must not block and
+        /// can be called from any thread.
+        virtual void post(std::function<void()> task) = 0;
+    };
+
+    /// Runs the posted tasks on another executor, one after the other
+    /// in the order they got posted; a strand never runs two of its
+    /// tasks concurrently even on a multi-threaded executor.
+    struct HTTP_API strand :
+        public executor
+    {
+        explicit strand(std::shared_ptr<executor> target);
+        virtual ~strand();
+
+        virtual void post(std::function<void()> task) override;
+
+    private:
+        struct state;
+        std::shared_ptr<state> m_state;
+
+    private:
+        strand(strand const&); // = delete;
+        strand& operator=(strand const&); // = delete;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
@@ -0,0 +1,83 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <cstddef>
+
+namespace http {
+
+    /// Configures how the data of a http::client::receive_file gets
+    /// written to disk.
+    struct file_sink_options {
+        file_sink_options() :
+            async(false),
+            buffer_size(1024 * 1024),
+            max_pending_buffers(4),
+            preallocate(false),
+            direct_io(false),
+            durable(false)
+        { }
+
+        /// Lets the worker loop only copy the received data into memory
+        /// buffers, which get written to the file by a dedicated pool of
+        /// writer threads (see http::loop_options::file_writer_threads),
+        /// so that a stalling disk cannot delay the transfers of other
+        /// requests; the request finishes once all data got written. If
+        /// not set libcurl writes to the file directly from the worker
+        /// loop. Note that the on_finish callback, the final on_receive
+        /// call, and a completion_queue push then happen on a writer
+        /// thread (unless a http::client::callback_executor is set) and
+        /// that each file takes up to max_pending_buffers buffers of
+        /// memory. The default value is false.
+        bool async;
+
+        /// The size of each memory buffer; it gets rounded up to a
+        /// multiple of 4 KiB. The default value is 1 MiB.
+        size_t buffer_size;
+
+        /// The maximum number of filled buffers per file waiting to be
+        /// written; the transfer gets paused once the writer falls
+        /// further behind. The default value is 4.
+        size_t max_pending_buffers;
+
+        /// Reserves the disk space for the complete file up front if the
+        /// server announced the Content-Length of the response, which
+        /// avoids fragmentation and allocation overhead while writing.
+        /// Only supported on Linux. The default value is false.
+        bool preallocate;
+
+        /// Opens the file with O_DIRECT, bypassing the page cache (e.g.,
+        /// for very large downloads which should not evict other data
+        /// from the cache). Only supported on Linux; ignored if the file
+        /// system does not support it. The default value is false.
+        bool direct_io;
+
+        /// Flushes the written data to the disk (fdatasync()) before the
+        /// request gets reported as finished. The default value is false.
+        bool durable;
+    };
+
+} // namespace http
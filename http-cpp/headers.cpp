@@ -0,0 +1,273 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./headers.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+    struct interned_name {
+        const char* name;
+        size_t      size;
+    };
+
+    /// The well-known field names (in lower case) placed by a perfect hash
+    /// of their length, first, middle, and last character; the slot index
+    /// plus one is the interned id of a name.
+    const size_t INTERNED_SLOTS = 128;
+    const interned_name INTERNED[INTERNED_SLOTS] = {
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { "cookie", 6 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { "accept-language", 15 }, { "server", 6 }, { nullptr, 0 },
+        { nullptr, 0 }, { "vary", 4 }, { "location", 8 }, { "host", 4 },
+        { "accept-encoding", 15 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { "content-location", 16 }, { nullptr, 0 }, { nullptr, 0 }, { "if-none-match", 13 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { "content-length", 14 },
+        { "accept-ranges", 13 }, { nullptr, 0 }, { "pragma", 6 }, { "date", 4 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { "accept", 6 },
+        { "age", 3 }, { nullptr, 0 }, { "if-modified-since", 17 }, { nullptr, 0 },
+        { "access-control-allow-origin", 27 }, { "content-disposition", 19 }, { "keep-alive", 10 }, { "expect", 6 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { "expires", 7 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { "authorization", 13 }, { nullptr, 0 }, { "allow", 5 },
+        { nullptr, 0 }, { nullptr, 0 }, { "x-frame-options", 15 }, { nullptr, 0 },
+        { "etag", 4 }, { "content-type", 12 }, { "x-content-type-options", 22 }, { nullptr, 0 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { "content-range", 13 }, { nullptr, 0 }, { "retry-after", 11 },
+        { "set-cookie", 10 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { "strict-transport-security", 25 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { "link", 4 },
+        { "via", 3 }, { "content-language", 16 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { "connection", 10 },
+        { "content-encoding", 16 }, { nullptr, 0 }, { nullptr, 0 }, { "referer", 7 },
+        { nullptr, 0 }, { "accept-charset", 14 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { "cache-control", 13 }, { nullptr, 0 }, { "user-agent", 10 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { "last-modified", 13 },
+        { nullptr, 0 }, { nullptr, 0 }, { "transfer-encoding", 17 }, { nullptr, 0 },
+        { nullptr, 0 }, { "x-request-id", 12 }, { nullptr, 0 }, { nullptr, 0 },
+        { nullptr, 0 }, { nullptr, 0 }, { "www-authenticate", 16 }, { "upgrade", 7 },
+        { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 }, { nullptr, 0 },
+        { "alt-svc", 7 }, { "range", 5 }, { nullptr, 0 }, { nullptr, 0 },
+    };
+
+    // field names are plain ASCII tokens; no need for locale aware tolower()
+    inline char lower(char c) {
+        return (('A' <= c) && (c <= 'Z')) ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    inline size_t interned_slot(http::buffer_view name) {
+        auto n = name.size();
+        auto h = n * 8 + lower(name.data()[0]) * 34 + lower(name.data()[n - 1]) * 7 + lower(name.data()[n / 2]);
+        return (h % INTERNED_SLOTS);
+    }
+
+    bool iequals(http::buffer_view lhs, http::buffer_view rhs) {
+        if(lhs.size() != rhs.size()) { return false; }
+        for(size_t i = 0; i < lhs.size(); ++i) {
+            if(lower(lhs.data()[i]) != lower(rhs.data()[i])) { return false; }
+        }
+        return true;
+    }
+
+} // namespace
+
+http::headers::headers(std::initializer_list<std::pair<std::string, std::string>> init) {
+    for(auto&& f : init) { set(f.first, f.second); }
+}
+
+int http::headers::interned_id(http::buffer_view name) {
+    if(name.empty()) { return 0; }
+    auto slot = interned_slot(name);
+    auto&& candidate = INTERNED[slot];
+    if(!candidate.name || !iequals(name, http::buffer_view(candidate.name, candidate.size))) { return 0; }
+    return static_cast<int>(slot + 1);
+}
+
+http::buffer_view http::headers::at(http::buffer_view name) const {
+    auto index = index_of(name, interned_id(name));
+    if(index >= size()) { throw std::out_of_range("http::headers::at(): no such header field"); }
+    return field_at(index).second;
+}
+
+http::buffer_view http::headers::operator[](http::buffer_view name) const {
+    auto index = index_of(name, interned_id(name));
+    return ((index < size()) ? field_at(index).second : http::buffer_view());
+}
+
+void http::headers::set(http::buffer_view name, http::buffer_view value) {
+    auto id = interned_id(name);
+    set_field(index_of(name, id), id, name, value, false);
+}
+
+bool http::headers::insert(std::pair<std::string, std::string> const& field) {
+    auto id = interned_id(field.first);
+    auto index = index_of(field.first, id);
+    if(index < size()) { return false; }
+    set_field(index, id, field.first, field.second, false);
+    return true;
+}
+
+size_t http::headers::erase(http::buffer_view name) {
+    auto index = index_of(name, interned_id(name));
+    if(index >= size()) { return 0; }
+    auto& b = detach();
+    b.wasted += b.fields[index].name_size + b.fields[index].value_size;
+    b.fields.erase(b.fields.begin() + index);
+    compact(b);
+    return 1;
+}
+
+bool http::headers::parse_line(http::buffer_view line) {
+    auto data = line.data();
+    auto end  = line.end();
+
+    auto sep = std::search(data, end, ": ", ": " + 2);
+    if((sep == end) || (sep == data)) { return false; }
+
+    auto name  = http::buffer_view(data, sep - data);
+    auto value = http::buffer_view(sep + 2, end - (sep + 2));
+    auto id = interned_id(name);
+    set_field(index_of(name, id), id, name, value, true);
+    return true;
+}
+
+bool http::headers::equals(headers const& other) const {
+    if(m_block == other.m_block) { return true; }
+    if(size() != other.size()) { return false; }
+
+    // the names are unique within each object, so finding each field of
+    // this object in the other one (like a lookup would) is sufficient
+    for(size_t i = 0; i < size(); ++i) {
+        auto l = field_at(i);
+        auto index = other.index_of(l.first, m_block->fields[i].id);
+        if((index >= other.size()) || (other.field_at(index).second != l.second)) { return false; }
+    }
+    return true;
+}
+
+http::headers::value_type http::headers::field_at(size_t index) const {
+    assert(m_block && (index < m_block->fields.size()));
+    auto&& f = m_block->fields[index];
+    auto&& t = m_block->text;
+
+    value_type v;
+    v.first  = ((f.id && !f.name_size) ? http::buffer_view(INTERNED[f.id - 1].name, INTERNED[f.id - 1].size) : http::buffer_view(t.data() + f.name_offset, f.name_size));
+    v.second = http::buffer_view(t.data() + f.value_offset, f.value_size);
+    return v;
+}
+
+size_t http::headers::index_of(http::buffer_view name, int id) const {
+    if(!m_block) { return 0; }
+
+    auto&& fields = m_block->fields;
+    for(size_t i = 0; i < fields.size(); ++i) {
+        auto&& f = fields[i];
+        if(id ? (f.id == id) : ((f.id == 0) && (f.name_size == name.size()) && iequals(name, http::buffer_view(m_block->text.data() + f.name_offset, f.name_size)))) {
+            return i;
+        }
+    }
+    return fields.size();
+}
+
+void http::headers::set_field(size_t index, int id, http::buffer_view name, http::buffer_view value, bool lower_name) {
+    // the given value might point into this object's own text buffer
+    if(m_block && (m_block->text.data() <= value.data()) && (value.data() < m_block->text.data() + m_block->text.size())) {
+        auto copy = value.str();
+        return set_field(index, id, name, copy, lower_name);
+    }
+
+    auto& b = detach();
+
+    if(index < b.fields.size()) {
+        auto& f = b.fields[index];
+        if(value.size() <= f.value_size) {
+            std::copy(value.begin(), value.end(), &b.text[f.value_offset]);
+            b.wasted += f.value_size - value.size();
+        } else if(f.value_offset + f.value_size == b.text.size()) {
+            // the last value in the text grows in place
+            b.text.resize(f.value_offset);
+            b.text.append(value.data(), value.size());
+        } else {
+            b.wasted += f.value_size;
+            f.value_offset = static_cast<uint32_t>(b.text.size());
+            b.text.append(value.data(), value.size());
+        }
+        f.value_size = static_cast<uint32_t>(value.size());
+        compact(b);
+        return;
+    }
+
+    // interned names spelled like in the table (e.g., all parsed ones) need
+    // no copy; any other spelling gets kept like for all other names
+    auto store_name = (!id || (!lower_name && (name != http::buffer_view(INTERNED[id - 1].name, INTERNED[id - 1].size))));
+
+    field f;
+    f.id            = id;
+    f.name_offset   = static_cast<uint32_t>(b.text.size());
+    f.name_size     = static_cast<uint32_t>(store_name ? name.size() : 0);
+    if(store_name) {
+        if(lower_name) {
+            for(auto c : name) { b.text.push_back(lower(c)); }
+        } else {
+            b.text.append(name.data(), name.size());
+        }
+    }
+    f.value_offset  = static_cast<uint32_t>(b.text.size());
+    f.value_size    = static_cast<uint32_t>(value.size());
+    b.text.append(value.data(), value.size());
+    b.fields.push_back(f);
+}
+
+void http::headers::compact(block& b) {
+    // fields set over and over again (e.g., a refreshed authorization)
+    // must not grow the text without bounds
+    if((b.wasted < 256) || (b.wasted < b.text.size() / 2)) { return; }
+
+    auto text = std::string();
+    text.reserve(b.text.size() - b.wasted);
+    for(auto&& f : b.fields) {
+        auto name_offset = static_cast<uint32_t>(text.size());
+        text.append(b.text, f.name_offset, f.name_size);
+        auto value_offset = static_cast<uint32_t>(text.size());
+        text.append(b.text, f.value_offset, f.value_size);
+        f.name_offset  = name_offset;
+        f.value_offset = value_offset;
+    }
+    b.text.swap(text);
+    b.wasted = 0;
+}
+
+http::headers::block& http::headers::detach() {
+    if(!m_block) {
+        m_block = std::make_shared<block>();
+        m_block->text.reserve(512);
+        m_block->fields.reserve(16);
+    } else if(m_block.use_count() > 1) {
+        m_block = std::make_shared<block>(*m_block);
+    }
+    return *m_block;
+}
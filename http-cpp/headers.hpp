@@ -0,0 +1,204 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./buffer.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    /// A list of HTTP header fields with case-insensitive name lookup.
+    /// All names and values of a headers object are stored in a single
+    /// text buffer and the fields themselves in a flat vector, so that
+    /// parsing a response costs a few allocations in total instead of
+    /// several per field; well-known field names are interned and get
+    /// compared by their id.
+    ///
+    /// Note: this replaces the former std::map based implementation,
+    /// which behaved differently in these points:
+    /// - names and values are handed out as http::buffer_view instead of
+    ///   std::string const& (use str() for a copy),
+    /// - iteration follows the insertion order instead of being sorted
+    ///   by name,
+    /// - lookups ignore the case of the names; the names keep the case
+    ///   they got set with, except for parse_line() which turns them to
+    ///   lower case (so all names of a received response are lower case,
+    ///   as before),
+    /// - operator== compares like a lookup does: the order of the fields
+    ///   and the case of their names do not matter, but the case of
+    ///   their values does.
+    ///
+    /// The content is shared between copies (copy-on-write): copying a
+    /// headers object (e.g., for each received chunk message) is just a
+    /// reference count increment while the first modification of a
+    /// shared object copies the content. Names and values are handed out
+    /// as views which stay valid as long as the headers object does not
+    /// get modified or destroyed.
+    struct HTTP_API headers {
+        /// A single field; first is the name and second the value.
+        struct value_type {
+            http::buffer_view first;
+            http::buffer_view second;
+        };
+
+        /// A bidirectional iterator over the fields.
+        struct const_iterator {
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef headers::value_type             value_type;
+            typedef std::ptrdiff_t                  difference_type;
+            typedef value_type const*               pointer;
+            typedef value_type                      reference;
+
+            const_iterator(headers const* h = nullptr, size_t index = 0) : m_headers(h), m_index(index) { }
+
+            value_type          operator*()  const { return m_headers->field_at(m_index); }
+            value_type const*   operator->() const { m_current = m_headers->field_at(m_index); return &m_current; }
+
+            const_iterator& operator++() { ++m_index; return *this; }
+            const_iterator  operator++(int) { auto tmp = *this; ++m_index; return tmp; }
+            const_iterator& operator--() { --m_index; return *this; }
+            const_iterator  operator--(int) { auto tmp = *this; --m_index; return tmp; }
+
+            const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+            const_iterator  operator+(difference_type n) const { return const_iterator(m_headers, m_index + n); }
+            difference_type operator-(const_iterator const& other) const { return static_cast<difference_type>(m_index - other.m_index); }
+
+            friend bool operator==(const_iterator const& lhs, const_iterator const& rhs) { return (lhs.m_index == rhs.m_index); }
+            friend bool operator!=(const_iterator const& lhs, const_iterator const& rhs) { return (lhs.m_index != rhs.m_index); }
+
+        private:
+            headers const*      m_headers;
+            size_t              m_index;
+            mutable value_type  m_current;
+        };
+        typedef const_iterator iterator;
+
+        /// Assigns to or reads a single field; returned by the non-const
+        /// operator[] and only valid within the expression it has been
+        /// created in.
+        struct value_ref {
+            value_ref(headers& h, http::buffer_view name) : m_headers(h), m_name(name) { }
+
+            value_ref& operator=(http::buffer_view value) { m_headers.set(m_name, value); return *this; }
+            operator http::buffer_view() const { return static_cast<headers const&>(m_headers)[m_name]; }
+            http::buffer str() const { return static_cast<http::buffer_view>(*this).str(); }
+
+        private:
+            headers&            m_headers;
+            http::buffer_view   m_name;
+        };
+
+        headers() { }
+        headers(std::initializer_list<std::pair<std::string, std::string>> init);
+
+        const_iterator begin()  const { return const_iterator(this, 0); }
+        const_iterator end()    const { return const_iterator(this, size()); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend()   const { return end(); }
+
+        bool    empty() const { return (size() == 0); }
+        size_t  size()  const { return (m_block ? m_block->fields.size() : 0); }
+
+        size_t          count(http::buffer_view name) const { return (index_of(name, interned_id(name)) < size() ? 1 : 0); }
+        const_iterator  find(http::buffer_view name)  const { return const_iterator(this, index_of(name, interned_id(name))); }
+
+        /// Returns the value of the given field; throws std::out_of_range
+        /// if there is no such field.
+        http::buffer_view at(http::buffer_view name) const;
+
+        /// Returns the value of the given field or an empty view if there
+        /// is no such field.
+        http::buffer_view operator[](http::buffer_view name) const;
+        value_ref operator[](http::buffer_view name) { return value_ref(*this, name); }
+
+        /// Sets the value of the given field, adding the field if needed;
+        /// an existing field keeps the spelling of its name.
+        void set(http::buffer_view name, http::buffer_view value);
+
+        /// Adds the given field unless a field with that name exists
+        /// already; returns whether it has been added.
+        bool insert(std::pair<std::string, std::string> const& field);
+
+        /// Removes the given field; returns the number of removed fields.
+        size_t erase(http::buffer_view name);
+
+        void clear() { m_block.reset(); }
+
+        /// Parses a "name: value" header line (without the line break)
+        /// and sets the field with its name in lower case; returns false
+        /// if the line does not contain a header field.
+        bool parse_line(http::buffer_view line);
+
+        /// Returns the id of the given interned (well-known) field name
+        /// or 0 if the name is not interned.
+        static int interned_id(http::buffer_view name);
+
+        friend bool operator==(headers const& lhs, headers const& rhs) { return lhs.equals(rhs); }
+        friend bool operator!=(headers const& lhs, headers const& rhs) { return !(lhs == rhs); }
+
+    private:
+        struct field {
+            uint32_t    name_offset;
+            uint32_t    name_size;
+            uint32_t    value_offset;
+            uint32_t    value_size;
+            int         id; // the interned id of the name or 0
+        };
+
+        struct block {
+            block() : wasted(0) { }
+
+            std::string         text;
+            std::vector<field>  fields;
+            size_t              wasted; // bytes of text no field refers to anymore
+        };
+
+        bool        equals(headers const& other) const;
+        value_type  field_at(size_t index) const;
+        size_t      index_of(http::buffer_view name, int id) const;
+        void        set_field(size_t index, int id, http::buffer_view name, http::buffer_view value, bool lower_name);
+        block&      detach();
+        static void compact(block& b);
+
+        std::shared_ptr<block> m_block;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
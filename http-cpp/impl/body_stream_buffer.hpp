@@ -0,0 +1,241 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace http {
+    namespace impl {
+
+        /// The bounded ring buffer between the worker loop writing the
+        /// received body and the reader of a http::body_stream. A write
+        /// not fitting into the buffer gets refused, which pauses the
+        /// transfer; on_resume gets called once the reader made enough
+        /// room for the transfer to continue. If no reader has been
+        /// opened by then, nobody would ever resume the transfer, so the
+        /// buffer gets closed instead.
+        struct body_stream_buffer {
+            explicit body_stream_buffer(size_t capacity) :
+                m_ring(capacity),
+                m_head(0),
+                m_used(0),
+                m_finished(false),
+                m_closed(false),
+                m_opened(false),
+                m_paused(false),
+                m_pending_data(nullptr),
+                m_pending_size(0)
+            { }
+
+            /// Called without holding any lock; set before the transfer starts.
+            std::function<void()> on_resume;
+
+            /// Stores the given data; returns false if it does not fit.
+            /// Called from the worker loop.
+            bool write(const char* data, size_t size) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if(m_closed) { return true; } // nobody is interested anymore
+
+                if(m_used + size > m_ring.size()) {
+                    if(!m_opened) {
+                        discard();
+                        return true;
+                    }
+                    if(m_used > 0) {
+                        m_paused = true;
+                        return false;
+                    }
+                    // a single chunk larger than the whole buffer
+                    m_ring.resize(size);
+                    m_head = 0;
+                }
+
+                // a pending asynchronous read gets served directly
+                if(m_pending_handler) {
+                    assert(m_used == 0);
+                    auto n = std::min(size, m_pending_size);
+                    std::memcpy(m_pending_data, data, n);
+                    data += n;
+                    size -= n;
+                    append(data, size);
+
+                    auto handler = std::move(m_pending_handler);
+                    m_pending_handler = nullptr;
+                    lock.unlock();
+                    handler(n);
+                    return true;
+                }
+
+                append(data, size);
+                lock.unlock();
+                m_readable.notify_one();
+                return true;
+            }
+
+            /// Marks the end of the body; called from the worker loop.
+            void finish() {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_finished = true;
+                auto handler = std::move(m_pending_handler);
+                m_pending_handler = nullptr;
+                lock.unlock();
+                m_readable.notify_all();
+                if(handler) { handler(0); }
+            }
+
+            /// Marks that a reader exists which is going to drain the
+            /// buffer; called by http::request::stream().
+            void open() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_opened = true;
+            }
+
+            /// Discards all current and future data; called once the last
+            /// reader is gone.
+            void close() {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                discard();
+                auto resume = m_paused;
+                m_paused = false;
+                lock.unlock();
+                if(resume && on_resume) { on_resume(); }
+            }
+
+            /// Copies up to size bytes of the available data; does not block.
+            size_t read_some(void* data, size_t size) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                return consume(lock, data, size);
+            }
+
+            /// Waits for data or the end of the body, but not beyond the
+            /// given timeout time; returns 0 only at the end of the body or
+            /// on a timeout.
+            size_t read_until(void* data, size_t size, std::chrono::steady_clock::time_point timeout_time) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_readable.wait_until(lock, timeout_time, [this]() { return ((m_used > 0) || m_finished); });
+                return consume(lock, data, size);
+            }
+
+            /// Waits for data or the end of the body; returns 0 only at the
+            /// end of the body.
+            size_t read(void* data, size_t size) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_readable.wait(lock, [this]() { return ((m_used > 0) || m_finished); });
+                return consume(lock, data, size);
+            }
+
+            /// Calls the handler with the number of bytes copied into the
+            /// given buffer, either right away or from the worker loop once
+            /// new data arrived; 0 signals the end of the body. Only a single
+            /// asynchronous read can be pending at any time.
+            void async_read(void* data, size_t size, std::function<void(size_t)> handler) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                assert(!m_pending_handler);
+                if((m_used > 0) || m_finished || (size == 0)) {
+                    auto n = consume(lock, data, size);
+                    handler(n);
+                    return;
+                }
+                m_pending_data      = static_cast<char*>(data);
+                m_pending_size      = size;
+                m_pending_handler   = std::move(handler);
+            }
+
+            size_t available() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_used;
+            }
+
+            bool eof() const {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return (m_finished && (m_used == 0));
+            }
+
+        private:
+            void discard() {
+                m_closed = true;
+                m_head = 0;
+                m_used = 0;
+                m_ring = std::vector<char>();
+            }
+
+            void append(const char* data, size_t size) {
+                auto tail = (m_head + m_used) % m_ring.size();
+                auto first = std::min(size, m_ring.size() - tail);
+                std::memcpy(&m_ring[tail], data, first);
+                std::memcpy(&m_ring[0], data + first, size - first);
+                m_used += size;
+            }
+
+            /// Copies available data out of the ring and resumes a paused
+            /// transfer once half of the buffer is free again; unlocks the
+            /// given lock.
+            size_t consume(std::unique_lock<std::mutex>& lock, void* data, size_t size) {
+                auto n = std::min(size, m_used);
+                if(n > 0) {
+                    auto out = static_cast<char*>(data);
+                    auto first = std::min(n, m_ring.size() - m_head);
+                    std::memcpy(out, &m_ring[m_head], first);
+                    std::memcpy(out + first, &m_ring[0], n - first);
+                    m_head = (m_head + n) % m_ring.size();
+                    m_used -= n;
+                }
+
+                auto resume = (m_paused && (m_used <= m_ring.size() / 2));
+                if(resume) { m_paused = false; }
+                lock.unlock();
+
+                if(resume && on_resume) { on_resume(); }
+                return n;
+            }
+
+            mutable std::mutex          m_mutex;
+            std::condition_variable     m_readable;
+            std::vector<char>           m_ring;
+            size_t                      m_head;
+            size_t                      m_used;
+            bool                        m_finished;
+            bool                        m_closed;
+            bool                        m_opened;
+            bool                        m_paused;
+
+            // a pending asynchronous read waiting for data
+            char*                       m_pending_data;
+            size_t                      m_pending_size;
+            std::function<void(size_t)> m_pending_handler;
+
+        private:
+            body_stream_buffer(body_stream_buffer const&); // = delete;
+            body_stream_buffer& operator=(body_stream_buffer const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
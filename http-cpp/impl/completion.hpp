@@ -0,0 +1,123 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <time.h>
+#   include <unistd.h>
+#else // defined(__linux__)
+#   include <condition_variable>
+#   include <mutex>
+#endif // defined(__linux__)
+
+namespace http {
+    namespace impl {
+
+        /// A one-shot event signaling the completion of a request; waiting
+        /// threads block on a futex on Linux and on a condition variable
+        /// elsewhere. Completing it without any waiting thread is just an
+        /// atomic store and load.
+        struct completion {
+#if defined(__linux__)
+            completion() : m_state(0), m_waiters(0) { }
+#else // defined(__linux__)
+            completion() : m_state(0) { }
+#endif // defined(__linux__)
+
+            bool ready() const { return (m_state.load(std::memory_order_acquire) != 0); }
+
+            void complete() {
+#if defined(__linux__)
+                m_state.store(1);
+                if(m_waiters.load() > 0) {
+                    syscall(SYS_futex, futex_word(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+                }
+#else // defined(__linux__)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_state.store(1);
+                }
+                m_cv.notify_all();
+#endif // defined(__linux__)
+            }
+
+            void wait() {
+                if(ready()) { return; }
+#if defined(__linux__)
+                ++m_waiters;
+                while(!ready()) {
+                    syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+                }
+                --m_waiters;
+#else // defined(__linux__)
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&]() { return ready(); });
+#endif // defined(__linux__)
+            }
+
+            /// Returns false if the timeout time has been reached before
+            /// the completion.
+            bool wait_until(std::chrono::steady_clock::time_point timeout_time) {
+                if(ready()) { return true; }
+#if defined(__linux__)
+                ++m_waiters;
+                while(!ready()) {
+                    auto remaining = timeout_time - std::chrono::steady_clock::now();
+                    if(remaining <= std::chrono::steady_clock::duration::zero()) { break; }
+
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+                    timespec timeout;
+                    timeout.tv_sec  = static_cast<time_t>(ns / 1000000000);
+                    timeout.tv_nsec = static_cast<long>(ns % 1000000000);
+                    syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, 0, &timeout, nullptr, 0);
+                }
+                --m_waiters;
+                return ready();
+#else // defined(__linux__)
+                std::unique_lock<std::mutex> lock(m_mutex);
+                return m_cv.wait_until(lock, timeout_time, [&]() { return ready(); });
+#endif // defined(__linux__)
+            }
+
+        private:
+            std::atomic<uint32_t>   m_state;
+#if defined(__linux__)
+            std::atomic<uint32_t>   m_waiters;
+
+            int* futex_word() { return reinterpret_cast<int*>(&m_state); }
+#else // defined(__linux__)
+            std::mutex              m_mutex;
+            std::condition_variable m_cv;
+#endif // defined(__linux__)
+        };
+
+    } // namespace impl
+} // namespace http
@@ -0,0 +1,111 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+namespace http {
+    namespace impl {
+
+        /// A bounded pool of easy handles which got reset via curl_easy_reset()
+        /// after their last use; reusing them saves the allocations done by
+        /// curl_easy_init() and curl_easy_cleanup() for each request. The
+        /// given prepare function (e.g., setting the default options) gets
+        /// applied to each new handle and to each handle right after its
+        /// reset, so that an acquired handle is always prepared already.
+        struct curl_easy_pool {
+            curl_easy_pool(size_t capacity, void (*prepare)(CURL*) = nullptr) :
+                m_capacity(capacity),
+                m_prepare(prepare),
+                m_hits(0),
+                m_misses(0)
+            {
+                m_handles.reserve(capacity);
+            }
+
+            ~curl_easy_pool() {
+                for(auto&& h : m_handles) { curl_easy_cleanup(h); }
+            }
+
+            CURL* acquire() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(!m_handles.empty()) {
+                        auto handle = m_handles.back();
+                        m_handles.pop_back();
+                        ++m_hits;
+                        return handle;
+                    }
+                }
+
+                ++m_misses;
+                auto handle = curl_easy_init();
+                if(handle && m_prepare) { m_prepare(handle); }
+                return handle;
+            }
+
+            void release(CURL* handle) {
+                assert(handle);
+
+                // resetting keeps the internal buffers, the DNS cache, and
+                // the TLS session ID cache of the handle; the thread
+                // releasing it pays for the preparation instead of the
+                // thread starting the next request
+                curl_easy_reset(handle);
+                if(m_prepare) { m_prepare(handle); }
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(m_handles.size() < m_capacity) {
+                        m_handles.push_back(handle);
+                        return;
+                    }
+                }
+
+                curl_easy_cleanup(handle);
+            }
+
+            size_t hits() const     { return m_hits;   }
+            size_t misses() const   { return m_misses; }
+
+        private:
+            std::mutex          m_mutex;
+            const size_t        m_capacity;
+            void              (*m_prepare)(CURL*);
+            std::vector<CURL*>  m_handles;
+            std::atomic<size_t> m_hits;
+            std::atomic<size_t> m_misses;
+
+        private:
+            curl_easy_pool(curl_easy_pool const&); // = delete;
+            curl_easy_pool& operator=(curl_easy_pool const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
@@ -23,31 +23,44 @@
 
 #pragma once
 
+#include "./curl_easy_pool.hpp"
+
 #include <curl/curl.h>
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <memory>
 
 namespace http {
     namespace impl {
 
         struct curl_easy_wrap {
-            curl_easy_wrap(CURL* master = nullptr) :
-                handle(master ? curl_easy_duphandle(master) : curl_easy_init()),
+            curl_easy_wrap(std::shared_ptr<curl_easy_pool> pool = nullptr, CURL* master = nullptr) :
+                handle(master ? curl_easy_duphandle(master) : (pool ? pool->acquire() : curl_easy_init())),
+                pool(std::move(pool)),
                 headers(nullptr),
                 post_data(nullptr),
-                post_data_last(nullptr)
+                post_data_last(nullptr),
+                queue_depth(0),
+                queue_wait(0)
             {
                 assert(handle);
 
                 error_buffer[0] = 0x00; // ensure a zero-terminating of the error buffer
 
-                if(!master) { set_default_values(); }
+                // cloned and pooled handles carry the default values already
+                if(!master && !this->pool) { set_default_values(handle); }
                 set_callbacks();
             }
 
             virtual ~curl_easy_wrap() {
                 assert(handle);
-                curl_easy_cleanup(handle);
+                if(pool) {
+                    pool->release(handle);
+                } else {
+                    curl_easy_cleanup(handle);
+                }
 
                 curl_slist_free_all(headers);
 
@@ -55,7 +68,7 @@ namespace http {
             }
 
         public:
-            void set_default_values() {
+            static void set_default_values(CURL* handle) {
 //                curl_easy_setopt(handle, CURLOPT_VERBOSE,               1);
 
                 curl_easy_setopt(handle, CURLOPT_AUTOREFERER,           1);
@@ -66,7 +79,6 @@ namespace http {
 #if (LIBCURL_VERSION_NUM >= 0x071900) // >= 7.25.0
                 curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE,         1);
 #endif // (LIBCURL_VERSION_NUM >= 0x071900)
-                curl_easy_setopt(handle, CURLOPT_ERRORBUFFER,           error_buffer);
 
                 curl_easy_setopt(handle, CURLOPT_SSLVERSION,            CURL_SSLVERSION_TLSv1); // explicitly disable SSLv3 and below; only allow TLSv1.x
 #if (LIBCURL_VERSION_NUM >= 0x072400) // >= 7.36.0
@@ -76,6 +88,7 @@ namespace http {
 
             void set_callbacks() {
                 curl_easy_setopt(handle, CURLOPT_PRIVATE,           this);
+                curl_easy_setopt(handle, CURLOPT_ERRORBUFFER,       error_buffer);
                 curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION,     write_stub);
                 curl_easy_setopt(handle, CURLOPT_WRITEDATA,         this);
                 curl_easy_setopt(handle, CURLOPT_READFUNCTION,      read_stub);
@@ -98,7 +111,7 @@ namespace http {
             }
 
         public:
-            virtual bool   write(const void* ptr, size_t bytes) = 0;
+            virtual size_t write(const void* ptr, size_t bytes) = 0; // the consumed bytes or CURL_WRITEFUNC_PAUSE
             virtual size_t read(void* ptr, size_t bytes) = 0;
             virtual void   header(const void* ptr, size_t bytes) = 0;
             virtual bool   seek(int64_t offset, int origin) = 0;
@@ -141,7 +154,7 @@ namespace http {
             static size_t write_stub(void* ptr, size_t size, size_t nmemb, void* userdata) {
                 auto wrap = static_cast<curl_easy_wrap*>(userdata); assert(wrap);
                 auto bytes = size * nmemb;
-                return (wrap->write(ptr, bytes) ? bytes : 0);
+                return wrap->write(ptr, bytes);
             }
 
             static  size_t read_stub(void* ptr, size_t size, size_t nmemb, void* userdata) {
@@ -191,11 +204,18 @@ namespace http {
 
         public:
             CURL* const     handle;
+            std::shared_ptr<curl_easy_pool> const pool;
             curl_slist*     headers;
             curl_httppost*  post_data;
             curl_httppost*  post_data_last;
             char            error_buffer[CURL_ERROR_SIZE];
 
+            // admission info maintained by the worker loop: the number of
+            // requests queued ahead of this one and the time it waited
+            std::chrono::steady_clock::time_point           queued_at;
+            std::atomic<size_t>                             queue_depth;
+            std::atomic<std::chrono::steady_clock::rep>     queue_wait;
+
         private:
             curl_easy_wrap(curl_easy_wrap const&); // = delete;
             curl_easy_wrap& operator=(curl_easy_wrap const&); // = delete;
@@ -23,151 +23,516 @@
 
 #pragma once
 
+#include "../loop_options.hpp"
+#include "../loop_statistics.hpp"
+#include "./curl_easy_pool.hpp"
+#include "./curl_easy_wrap.hpp"
+#include "./curl_share_wrap.hpp"
+#include "./mpsc_queue.hpp"
+
 #include <curl/curl.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#if defined(__linux__)
+#   include <sys/epoll.h>
+#   include <sys/eventfd.h>
+#   include <unistd.h>
+#   define HTTP_CPP_HAS_EPOLL
+#endif // defined(__linux__)
 
 namespace http {
     namespace impl {
 
         struct curl_multi_wrap {
-            curl_multi_wrap() :
+            curl_multi_wrap(http::loop_options const& options = http::loop_options(), curl_share_wrap* share = nullptr) :
                 m_multi(curl_multi_init()),
+                m_share(share),
+                m_easy_pool(options.easy_handle_pool_size ? std::make_shared<curl_easy_pool>(options.easy_handle_pool_size, &curl_easy_wrap::set_default_values) : nullptr),
+                m_engine(options.engine),
+                m_epoll(-1),
+                m_wakeup_event(-1),
+                m_timer_active(false),
+                m_max_active_requests(options.max_active_requests),
+                m_active_count(0),
+                m_queued_requests(0),
+                m_resumed_transfers(0),
+                m_new_connections(0),
+                m_reused_connections(0),
+                m_waiting(false),
                 m_worker_shutdown(false)
             {
                 assert(m_multi);
 
+#if (LIBCURL_VERSION_NUM >= 0x072B00) // >= 7.43.0
+                curl_multi_setopt(m_multi, CURLMOPT_PIPELINING,             options.multiplex ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+#endif // (LIBCURL_VERSION_NUM >= 0x072B00)
+#if (LIBCURL_VERSION_NUM >= 0x074300) // >= 7.67.0
+                curl_multi_setopt(m_multi, CURLMOPT_MAX_CONCURRENT_STREAMS, static_cast<long>(options.max_concurrent_streams));
+#endif // (LIBCURL_VERSION_NUM >= 0x074300)
+#if (LIBCURL_VERSION_NUM >= 0x071E00) // >= 7.30.0
+                curl_multi_setopt(m_multi, CURLMOPT_MAX_TOTAL_CONNECTIONS,  static_cast<long>(options.max_total_connections));
+                curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS,   static_cast<long>(options.max_host_connections));
+#endif // (LIBCURL_VERSION_NUM >= 0x071E00)
+                if(options.max_cached_connections > 0) {
+                    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS,        static_cast<long>(options.max_cached_connections));
+                }
+
+#if defined(HTTP_CPP_HAS_EPOLL)
+                if(m_engine == HTTP_LOOP_ENGINE_EPOLL) { init_epoll(); }
+#else // defined(HTTP_CPP_HAS_EPOLL)
+                m_engine = HTTP_LOOP_ENGINE_POLL;
+#endif // defined(HTTP_CPP_HAS_EPOLL)
+
                 // start the worker thread
                 m_worker = std::thread([this]() { loop(); });
             }
 
             ~curl_multi_wrap() {
                 m_worker_shutdown = true;
+                wakeup();
                 m_worker.join();
 
                 assert(m_active_handles.empty());
+                assert(m_admission.empty());
+                assert(m_pending.empty());
 
                 assert(m_multi);
 // TODO: this cleanup call seems to be defect on Windows => ignore it for now
-//                if(m_multi) { curl_multi_cleanup(m_multi); }
+#if !defined(WIN32)
+                curl_multi_cleanup(m_multi);
+#endif // !defined(WIN32)
+
+#if defined(HTTP_CPP_HAS_EPOLL)
+                if(m_wakeup_event != -1) { close(m_wakeup_event); }
+                if(m_epoll != -1)        { close(m_epoll); }
+#endif // defined(HTTP_CPP_HAS_EPOLL)
             }
 
             void wait_for_all() {
-                while(true) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                std::unique_lock<std::mutex> lock(m_idle_mutex);
+                m_idle.wait(lock, [this]() { return (m_active_count == 0); });
+            }
 
-                    std::lock_guard<std::mutex> lock(m_mutex);
-                    if(m_active_handles.empty()) { break; }
-                }
+            /// Returns false if the given timeout time got reached before
+            /// all requests finished.
+            bool wait_until_all(std::chrono::steady_clock::time_point timeout_time) {
+                std::unique_lock<std::mutex> lock(m_idle_mutex);
+                return m_idle.wait_until(lock, timeout_time, [this]() { return (m_active_count == 0); });
             }
 
             void cancel_all() {
-                {   // first cancel all active handles
-                    std::lock_guard<std::mutex> lock(m_mutex);
-                    for(auto&& i : m_active_handles) {
-                        i.second->cancel();
-                    }
-                }
+                // first cancel all active handles
+                submit(OP_CANCEL_ALL, nullptr);
 
                 // then wait for them to finish
                 wait_for_all();
             }
 
+            /// Returns the number of requests currently handled by this loop.
+            size_t active_count() const {
+                return m_active_count;
+            }
+
+            /// Returns the pool new requests of this loop take their easy
+            /// handles from; might be a nullptr.
+            std::shared_ptr<curl_easy_pool> const& easy_pool() const {
+                return m_easy_pool;
+            }
+
+            /// Adds the counters of this loop to the given statistics.
+            void collect(http::loop_statistics& stats) const {
+                if(m_easy_pool) {
+                    stats.easy_handle_pool_hits     += m_easy_pool->hits();
+                    stats.easy_handle_pool_misses   += m_easy_pool->misses();
+                }
+                stats.new_connections       += m_new_connections;
+                stats.reused_connections    += m_reused_connections;
+                stats.queued_requests       += m_queued_requests;
+                stats.resumed_transfers     += m_resumed_transfers;
+            }
+
         public:
+            // The curl multi handle and the list of active handles are only
+            // touched by the worker thread; the following methods just queue
+            // the request for it and never block on the worker thread.
+
             void add(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
                 assert(wrap);
+                if(m_share) { m_share->add(wrap->handle); }
+                wrap->queued_at = std::chrono::steady_clock::now();
+                ++m_active_count;
+                submit(OP_ADD, std::move(wrap));
+            }
 
-                auto handle = wrap->handle;
-                assert(handle);
+            void remove(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+                assert(wrap);
+                submit(OP_REMOVE, std::move(wrap));
+            }
 
-                std::lock_guard<std::mutex> lock(m_mutex);
-                assert(m_active_handles[handle] == nullptr);
-                m_active_handles[handle] = wrap;
+            void cancel(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+                assert(wrap);
+                wrap->cancel();
 
-                curl_multi_add_handle(m_multi, handle);
+                // abort the transfer from the worker thread right away
+                // instead of waiting for the next progress callback
+                submit(OP_CANCEL, std::move(wrap));
             }
 
-            void remove(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+            /// Continues a transfer paused by its write callback (see
+            /// CURL_WRITEFUNC_PAUSE); libcurl requires this to happen on
+            /// the worker thread.
+            void resume(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
                 assert(wrap);
+                submit(OP_RESUME, std::move(wrap));
+            }
 
-                auto handle = wrap->handle;
-                assert(handle);
+            /// Interrupts a potentially blocking wait of the worker thread
+            /// for socket activity; can be called from any thread.
+            void wakeup() {
+#if defined(HTTP_CPP_HAS_EPOLL)
+                if(m_engine == HTTP_LOOP_ENGINE_EPOLL) {
+                    const uint64_t one = 1;
+                    auto res = ::write(m_wakeup_event, &one, sizeof(one));
+                    (void)res; // a failing write means the counter is already signaled
+                    return;
+                }
+#endif // defined(HTTP_CPP_HAS_EPOLL)
+
+#if (LIBCURL_VERSION_NUM >= 0x074400) // >= 7.68.0
+                curl_multi_wakeup(m_multi);
+#endif // (LIBCURL_VERSION_NUM >= 0x074400)
+            }
+
+        private:
+            enum pending_op { OP_ADD, OP_REMOVE, OP_CANCEL, OP_CANCEL_ALL, OP_RESUME };
+            typedef std::pair<pending_op, std::shared_ptr<http::impl::curl_easy_wrap>> pending_entry;
+
+            void submit(pending_op op, std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+                m_pending.push(pending_entry(op, std::move(wrap)));
 
-                std::lock_guard<std::mutex> lock(m_mutex);
+                // only pay for a wakeup if the worker thread is (about to be) blocked
+                if(m_waiting.exchange(false)) { wakeup(); }
+            }
+
+            /// Detaches the given handle and reports it as canceled; the
+            /// handle queues its removal once it is finished.
+            void abort_handle(std::shared_ptr<http::impl::curl_easy_wrap> wrap, std::vector<std::function<void()>>& update_handles) {
+                auto handle = wrap->handle;
                 if(m_active_handles.erase(handle)) {
                     curl_multi_remove_handle(m_multi, handle);
+                } else {
+                    // the request is still waiting for its admission
+                    m_admission.erase(std::find(m_admission.begin(), m_admission.end(), wrap));
+                }
+
+                long status = http::HTTP_000_UNKNOWN;
+                curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+
+                update_handles.emplace_back([=]() { wrap->finish(CURLE_ABORTED_BY_CALLBACK, status); });
+            }
+
+            /// Hands the given request over to libcurl.
+            void admit(std::shared_ptr<http::impl::curl_easy_wrap> wrap) {
+                auto handle = wrap->handle;
+                assert(!m_active_handles.count(handle));
+                wrap->queue_wait = (std::chrono::steady_clock::now() - wrap->queued_at).count();
+                m_active_handles[handle] = std::move(wrap);
+                curl_multi_add_handle(m_multi, handle);
+            }
+
+            /// Admits as many requests from the admission queue as the
+            /// limit for active requests allows.
+            void admit_queued() {
+                while(!m_admission.empty() && (m_active_handles.size() < m_max_active_requests)) {
+                    auto wrap = std::move(m_admission.front());
+                    m_admission.pop_front();
+                    admit(std::move(wrap));
+                }
+            }
+
+            void apply_pending(std::vector<std::function<void()>>& update_handles) {
+                pending_entry p;
+                while(m_pending.pop(p)) {
+                    auto wrap = std::move(p.second);
+
+                    switch(p.first) {
+                        case OP_ADD: {
+                            if((m_max_active_requests > 0) && (m_active_handles.size() >= m_max_active_requests)) {
+                                wrap->queue_depth = m_admission.size();
+                                m_admission.push_back(std::move(wrap));
+                                ++m_queued_requests;
+                            } else {
+                                admit(std::move(wrap));
+                            }
+                            break;
+                        }
+                        case OP_REMOVE: {
+                            // the handle got already erased from the active
+                            // handles when its finish() call got scheduled
+                            curl_multi_remove_handle(m_multi, wrap->handle);
+                            if(m_share) { m_share->remove(wrap->handle); }
+                            wrap.reset(); // release the handle before reporting it as finished
+
+                            if(--m_active_count == 0) {
+                                // the lock ensures that a waiter cannot miss the notification
+                                std::lock_guard<std::mutex> lock(m_idle_mutex);
+                                m_idle.notify_all();
+                            }
+                            break;
+                        }
+                        case OP_CANCEL: {
+                            // the request might have finished in the meantime
+                            if(!m_active_handles.count(wrap->handle) && (std::find(m_admission.begin(), m_admission.end(), wrap) == m_admission.end())) { break; }
+                            abort_handle(wrap, update_handles);
+                            break;
+                        }
+                        case OP_RESUME: {
+                            // the request might have finished in the meantime
+                            if(!m_active_handles.count(wrap->handle)) { break; }
+                            ++m_resumed_transfers;
+                            curl_easy_pause(wrap->handle, CURLPAUSE_CONT);
+                            break;
+                        }
+                        case OP_CANCEL_ALL: {
+                            auto active = std::vector<std::shared_ptr<http::impl::curl_easy_wrap>>(m_admission.begin(), m_admission.end());
+                            for(auto&& i : m_active_handles) { active.push_back(i.second); }
+                            for(auto&& w : active) {
+                                w->cancel();
+                                abort_handle(w, update_handles);
+                            }
+                            break;
+                        }
+                    }
                 }
             }
 
-        private:
             void loop() {
                 std::vector<std::function<void()>> update_handles;
                 while(!loop_stop()) {
                     update_handles.clear();
                     int running_handles = 0;
                     int mesages_left = 0;
-                    int wait_time_ms = 0;
-
-                    {   // perform curl multi operations within the locked mutex
-                        std::lock_guard<std::mutex> lock(m_mutex);
-                        auto perform_res = curl_multi_perform(m_multi, &running_handles);
-
-                        // check if we should call perform again immediately
-                        if(perform_res == CURLM_CALL_MULTI_PERFORM) {
-                            wait_time_ms = 0; // no wait
-                        } else if(!m_active_handles.empty()) {
-                            wait_time_ms = 10; // some handles are still active => use short wait
-                        } else {
-                            wait_time_ms = 100; // no handles are active right now => use longer wait
-                        }
 
-                        // retrieve the list of handles to update their state
-                        while(auto msg = curl_multi_info_read(m_multi, &mesages_left)) {
-                            auto handle = msg->easy_handle;
+                    // apply the queued add/remove/cancel requests
+                    apply_pending(update_handles);
+
+                    // perform curl multi operations; the epoll engine
+                    // performs the transfers in wait() instead
+                    auto perform_res = CURLM_OK;
+                    if(m_engine == HTTP_LOOP_ENGINE_POLL) {
+                        perform_res = curl_multi_perform(m_multi, &running_handles);
+                    }
 
-                            switch(msg->msg) {
-                                case CURLMSG_DONE: {
-                                    auto it = m_active_handles.find(handle);
-                                    assert(it != m_active_handles.end());
+                    // retrieve the list of handles to update their state
+                    while(auto msg = curl_multi_info_read(m_multi, &mesages_left)) {
+                        auto handle = msg->easy_handle;
 
-                                    auto wrap = it->second;
-                                    auto error = msg->data.result;
+                        switch(msg->msg) {
+                            case CURLMSG_DONE: {
+                                auto it = m_active_handles.find(handle);
+                                assert(it != m_active_handles.end());
 
-                                    long status = http::HTTP_000_UNKNOWN;
-                                    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+                                auto wrap = it->second;
+                                m_active_handles.erase(it);
+                                auto error = msg->data.result;
 
-                                    update_handles.emplace_back([=]() { wrap->finish(error, status); });
-                                    break;
-                                }
-                                default: {
-                                    assert(!"should not be reached");
-                                    break;
+                                long status = http::HTTP_000_UNKNOWN;
+                                curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+
+                                if(m_share && (error == CURLE_OK)) { m_share->record(handle); }
+
+                                long connects = 0;
+                                curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+                                if(connects > 0) {
+                                    m_new_connections += connects;
+                                } else if(error == CURLE_OK) {
+                                    ++m_reused_connections;
                                 }
+
+                                update_handles.emplace_back([=]() { wrap->finish(error, status); });
+                                break;
+                            }
+                            default: {
+                                assert(!"should not be reached");
+                                break;
                             }
                         }
                     }
 
-                    // update the done handles outside of the mutex
+                    // let queued requests take the place of the done ones
+                    admit_queued();
+
+                    // update the done handles
                     for(auto&& update_cb : update_handles) { update_cb(); }
-                    
-                    if(wait_time_ms > 0) {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(wait_time_ms));
+
+                    // the finished handles will queue their removal => loop again immediately
+                    if(!update_handles.empty()) { continue; }
+
+                    // check if we should call perform again immediately
+                    if(perform_res == CURLM_CALL_MULTI_PERFORM) { continue; }
+
+                    // announce the wait before the final check for queued
+                    // requests; see submit() for the other side
+                    m_waiting = true;
+                    if(m_pending.empty()) { wait(); }
+                    m_waiting = false;
+                }
+            }
+
+            /// Blocks until there is activity on one of the sockets, a
+            /// timeout of one of the transfers expires, or wakeup() gets
+            /// called.
+            void wait() {
+#if defined(HTTP_CPP_HAS_EPOLL)
+                if(m_engine == HTTP_LOOP_ENGINE_EPOLL) { wait_epoll(); return; }
+#endif // defined(HTTP_CPP_HAS_EPOLL)
+
+#if (LIBCURL_VERSION_NUM >= 0x074400) // >= 7.68.0
+                // curl_multi_poll() limits the wait time to the next
+                // timeout required by the running transfers itself
+                curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+#elif (LIBCURL_VERSION_NUM >= 0x071c00) // >= 7.28.0
+                // no wakeup support => use a short wait time in order to
+                // pick up new requests in time
+                curl_multi_wait(m_multi, nullptr, 0, 10, nullptr);
+#else
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+            }
+
+#if defined(HTTP_CPP_HAS_EPOLL)
+            void init_epoll() {
+                m_epoll = epoll_create1(EPOLL_CLOEXEC);
+                m_wakeup_event = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+                assert(m_epoll != -1);
+                assert(m_wakeup_event != -1);
+
+                epoll_event ev = { };
+                ev.events  = EPOLLIN;
+                ev.data.fd = m_wakeup_event;
+                epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup_event, &ev);
+
+                curl_multi_setopt(m_multi, CURLMOPT_SOCKETFUNCTION, socket_stub);
+                curl_multi_setopt(m_multi, CURLMOPT_SOCKETDATA,     this);
+                curl_multi_setopt(m_multi, CURLMOPT_TIMERFUNCTION,  timer_stub);
+                curl_multi_setopt(m_multi, CURLMOPT_TIMERDATA,      this);
+            }
+
+            void wait_epoll() {
+                // libcurl manages the timeouts of all its transfers itself and
+                // only reports the next one due => a single deadline is enough
+                auto timeout_ms = 1000;
+                if(m_timer_active) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(m_timer_deadline - std::chrono::steady_clock::now()).count();
+                    timeout_ms = static_cast<int>(std::max<long long>(0, std::min<long long>(remaining, timeout_ms)));
+                }
+
+                epoll_event events[64];
+                auto count = epoll_wait(m_epoll, events, 64, timeout_ms);
+
+                int running_handles = 0;
+                for(int i = 0; i < count; ++i) {
+                    auto fd = events[i].data.fd;
+                    if(fd == m_wakeup_event) {
+                        uint64_t value = 0;
+                        auto res = ::read(m_wakeup_event, &value, sizeof(value));
+                        (void)res;
+                        continue;
                     }
+
+                    int mask = 0;
+                    if(events[i].events & EPOLLIN)                { mask |= CURL_CSELECT_IN;  }
+                    if(events[i].events & EPOLLOUT)               { mask |= CURL_CSELECT_OUT; }
+                    if(events[i].events & (EPOLLERR | EPOLLHUP))  { mask |= CURL_CSELECT_ERR; }
+                    curl_multi_socket_action(m_multi, fd, mask, &running_handles);
+                }
+
+                if(m_timer_active && (std::chrono::steady_clock::now() >= m_timer_deadline)) {
+                    m_timer_active = false;
+                    curl_multi_socket_action(m_multi, CURL_SOCKET_TIMEOUT, 0, &running_handles);
                 }
             }
-            
+
+            static int socket_stub(CURL* easy, curl_socket_t s, int what, void* userp, void* socketp) {
+                (void)easy;
+                auto wrap = static_cast<curl_multi_wrap*>(userp); assert(wrap);
+
+                if(what == CURL_POLL_REMOVE) {
+                    // the socket might already be closed which removes it from the epoll set anyway
+                    epoll_ctl(wrap->m_epoll, EPOLL_CTL_DEL, s, nullptr);
+                    curl_multi_assign(wrap->m_multi, s, nullptr);
+                    return 0;
+                }
+
+                epoll_event ev = { };
+                ev.data.fd = s;
+                if((what == CURL_POLL_IN)  || (what == CURL_POLL_INOUT)) { ev.events |= EPOLLIN;  }
+                if((what == CURL_POLL_OUT) || (what == CURL_POLL_INOUT)) { ev.events |= EPOLLOUT; }
+
+                // socketp is only set for sockets already registered with epoll
+                if(socketp) {
+                    epoll_ctl(wrap->m_epoll, EPOLL_CTL_MOD, s, &ev);
+                } else {
+                    epoll_ctl(wrap->m_epoll, EPOLL_CTL_ADD, s, &ev);
+                    curl_multi_assign(wrap->m_multi, s, wrap);
+                }
+                return 0;
+            }
+
+            static int timer_stub(CURLM* multi, long timeout_ms, void* userp) {
+                (void)multi;
+                auto wrap = static_cast<curl_multi_wrap*>(userp); assert(wrap);
+
+                wrap->m_timer_active = (timeout_ms >= 0);
+                if(wrap->m_timer_active) {
+                    wrap->m_timer_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+                }
+                return 0;
+            }
+#endif // defined(HTTP_CPP_HAS_EPOLL)
+
             bool loop_stop() {
-                if(!m_worker_shutdown) { return false; }
-                
-                std::lock_guard<std::mutex> lock(m_mutex);
-                return m_active_handles.empty();
+                return (m_worker_shutdown && (m_active_count == 0) && m_pending.empty());
             }
             
         private:
-            mutable std::mutex m_mutex;
             CURLM* const m_multi;
+            curl_share_wrap* const m_share;
+            std::shared_ptr<curl_easy_pool> const m_easy_pool;
+
+            http::loop_engine   m_engine;
+            int                 m_epoll;
+            int                 m_wakeup_event;
+
+            // the next timeout requested by libcurl (epoll engine only)
+            bool                                    m_timer_active;
+            std::chrono::steady_clock::time_point   m_timer_deadline;
             
+            // requests waiting for their admission (max_active_requests)
+            size_t const                                                  m_max_active_requests;
+            std::deque<std::shared_ptr<http::impl::curl_easy_wrap>>       m_admission;
+
             std::map<CURL*, std::shared_ptr<http::impl::curl_easy_wrap>> m_active_handles;
+            std::atomic<size_t>                                           m_active_count;
+            std::atomic<size_t>                                           m_queued_requests;
+            std::atomic<size_t>                                           m_resumed_transfers;
+
+            // connection reuse counters of the finished transfers
+            std::atomic<size_t>                                           m_new_connections;
+            std::atomic<size_t>                                           m_reused_connections;
+
+            // signaled each time the number of active requests drops to zero
+            std::mutex                  m_idle_mutex;
+            std::condition_variable     m_idle;
+
+            http::impl::mpsc_queue<pending_entry>   m_pending;
+            std::atomic<bool>                       m_waiting;
             
             std::thread         m_worker;
             std::atomic<bool>   m_worker_shutdown;
@@ -23,34 +23,68 @@
 
 #pragma once
 
+#include "../loop_statistics.hpp"
+#include "./rw_mutex.hpp"
+
 #include <curl/curl.h>
 
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <istream>
+#include <map>
 #include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace http {
     namespace impl {
 
         struct curl_share_wrap {
-            curl_share_wrap() :
-                m_share(curl_share_init())
+            curl_share_wrap(bool share_connections = false, bool record_hosts = false) :
+                m_share(curl_share_init()),
+                m_resolve_pending(false),
+                m_record_hosts(record_hosts)
             {
                 assert(m_share);
+                for(auto&& c : m_contention) { c = 0; }
+
                 curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC,   lock_function_stub);
                 curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlock_function_stub);
                 curl_share_setopt(m_share, CURLSHOPT_USERDATA,   this);
                 curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
                 curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
                 curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if (LIBCURL_VERSION_NUM >= 0x073900) // >= 7.57.0
+                if(share_connections) {
+                    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+                }
+#else // (LIBCURL_VERSION_NUM >= 0x073900)
+                (void)share_connections;
+#endif // (LIBCURL_VERSION_NUM >= 0x073900)
             }
 
             ~curl_share_wrap() {
                 assert(m_share);
                 curl_share_cleanup(m_share);
+                for(auto&& r : m_resolve) { curl_slist_free_all(r); }
             }
 
             void add(CURL* handle) {
                 assert(handle);
                 curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+
+                // the first transfer after a load() injects the preloaded
+                // host addresses into the shared DNS cache for all others
+                if(m_resolve_pending) {
+                    std::lock_guard<std::mutex> lock(m_resolve_mutex);
+                    if(m_resolve_pending.exchange(false)) {
+                        curl_easy_setopt(handle, CURLOPT_RESOLVE, m_resolve.back());
+                    }
+                }
             }
 
             void remove(CURL* handle) {
@@ -58,21 +92,233 @@ namespace http {
                 curl_easy_setopt(handle, CURLOPT_SHARE, nullptr);
             }
 
+            /// Adds the lock contention counters to the given statistics.
+            void collect(http::loop_statistics& stats) const {
+                stats.share_lock_contention_cookie      += m_contention[CURL_LOCK_DATA_COOKIE];
+                stats.share_lock_contention_dns         += m_contention[CURL_LOCK_DATA_DNS];
+                stats.share_lock_contention_ssl_session += m_contention[CURL_LOCK_DATA_SSL_SESSION];
+                stats.share_lock_contention_connect     += m_contention[CURL_LOCK_DATA_CONNECT];
+            }
+
+        public:
+            /// Remembers the address the given (successfully finished)
+            /// transfer connected to for a later save().
+            void record(CURL* handle) {
+                if(!m_record_hosts) { return; }
+
+#if (LIBCURL_VERSION_NUM >= 0x073E00) // >= 7.62.0
+                char* url = nullptr;
+                char* ip  = nullptr;
+                long port = 0;
+                curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL,  &url);
+                curl_easy_getinfo(handle, CURLINFO_PRIMARY_IP,     &ip);
+                curl_easy_getinfo(handle, CURLINFO_PRIMARY_PORT,   &port);
+                if(!url || !ip || !*ip || (port <= 0)) { return; }
+
+                auto host = std::string();
+                if(auto u = curl_url()) {
+                    char* h = nullptr;
+                    if((curl_url_set(u, CURLUPART_URL, url, 0) == CURLUE_OK) && (curl_url_get(u, CURLUPART_HOST, &h, 0) == CURLUE_OK)) {
+                        host = h;
+                        curl_free(h);
+                    }
+                    curl_url_cleanup(u);
+                }
+                if(host.empty() || (host == ip) || (host[0] == '[')) { return; } // nothing to resolve for IP literals
+
+                std::lock_guard<std::mutex> lock(m_hosts_mutex);
+                auto& entry = m_hosts[host + ":" + std::to_string(port)];
+                entry.first  = ip;
+                entry.second = std::time(nullptr);
+#else // (LIBCURL_VERSION_NUM >= 0x073E00)
+                (void)handle;
+#endif // (LIBCURL_VERSION_NUM >= 0x073E00)
+            }
+
+            /// Writes the recorded host addresses, valid for the given
+            /// time to live, and the cached TLS sessions (libcurl >= 8.12.0)
+            /// to the given stream.
+            void save(std::ostream& out, std::chrono::seconds dns_ttl) {
+                out << "http-cpp-session-cache 1\n";
+                {
+                    std::lock_guard<std::mutex> lock(m_hosts_mutex);
+                    auto now = std::time(nullptr);
+                    for(auto&& h : m_hosts) {
+                        auto expires = h.second.second + static_cast<std::time_t>(dns_ttl.count());
+                        if(expires <= now) { continue; }
+                        out << "dns " << h.first << " " << h.second.first << " " << static_cast<int64_t>(expires) << "\n";
+                    }
+                }
+
+#if (LIBCURL_VERSION_NUM >= 0x080C00) // >= 8.12.0
+                auto handle = curl_easy_init();
+                curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+                curl_easy_ssls_export(handle, ssls_export_stub, &out);
+                curl_easy_cleanup(handle);
+#endif // (LIBCURL_VERSION_NUM >= 0x080C00)
+            }
+
+            /// Preloads the host addresses and TLS sessions from the given
+            /// stream written by save(); expired entries get skipped.
+            /// Returns false if the stream has an unknown format.
+            bool load(std::istream& in) {
+                auto header = std::string();
+                auto version = 0;
+                if(!(in >> header >> version) || (header != "http-cpp-session-cache") || (version != 1)) {
+                    return false;
+                }
+
+                auto resolve_entries = std::vector<std::string>();
+                auto now = std::time(nullptr);
+                auto type = std::string();
+                while(in >> type) {
+                    if(type == "dns") {
+                        auto host_port = std::string(), ip = std::string();
+                        int64_t expires = 0;
+                        if(!(in >> host_port >> ip >> expires)) { return false; }
+                        if(expires <= now) { continue; }
+
+                        // a "+" lets the entry time out like a resolved one
+#if (LIBCURL_VERSION_NUM >= 0x074B00) // >= 7.75.0
+                        auto entry = "+" + host_port + ":";
+#else // (LIBCURL_VERSION_NUM >= 0x074B00)
+                        auto entry = host_port + ":";
+#endif // (LIBCURL_VERSION_NUM >= 0x074B00)
+                        entry += ((ip.find(':') != ip.npos) ? "[" + ip + "]" : ip);
+                        resolve_entries.push_back(entry);
+                    } else if(type == "tls") {
+                        auto key = std::string(), shmac = std::string(), sdata = std::string();
+                        int64_t valid_until = 0;
+                        if(!(in >> key >> shmac >> sdata >> valid_until)) { return false; }
+                        if((valid_until > 0) && (valid_until <= now)) { continue; }
+#if (LIBCURL_VERSION_NUM >= 0x080C00) // >= 8.12.0
+                        auto k = from_hex(key), m = from_hex(shmac), d = from_hex(sdata);
+                        auto session_key = std::string(k.begin(), k.end());
+                        auto handle = curl_easy_init();
+                        curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+                        curl_easy_ssls_import(
+                            handle, (session_key.empty() ? nullptr : session_key.c_str()),
+                            m.data(), m.size(), d.data(), d.size()
+                        );
+                        curl_easy_cleanup(handle);
+#endif // (LIBCURL_VERSION_NUM >= 0x080C00)
+                    } else {
+                        return false;
+                    }
+                }
+
+                if(!resolve_entries.empty()) {
+                    // a new list, since a running transfer might still read
+                    // the one handed out before
+                    curl_slist* resolve = nullptr;
+                    for(auto&& e : resolve_entries) { resolve = curl_slist_append(resolve, e.c_str()); }
+
+                    std::lock_guard<std::mutex> lock(m_resolve_mutex);
+                    if(m_resolve_pending) {
+                        // not injected yet => keep those addresses as well
+                        for(auto r = m_resolve.back(); r; r = r->next) {
+                            resolve = curl_slist_append(resolve, r->data);
+                        }
+                    }
+                    m_resolve.push_back(resolve);
+                    m_resolve_pending = true;
+                }
+                return true;
+            }
+
+        private:
+#if (LIBCURL_VERSION_NUM >= 0x080C00) // >= 8.12.0
+            static CURLcode ssls_export_stub(
+                CURL* handle, void* userptr, const char* session_key,
+                const unsigned char* shmac, size_t shmac_len,
+                const unsigned char* sdata, size_t sdata_len,
+                curl_off_t valid_until, int ietf_tls_id, const char* alpn, size_t earlydata_max
+            ) {
+                (void)handle; (void)ietf_tls_id; (void)alpn; (void)earlydata_max;
+                auto& out = *static_cast<std::ostream*>(userptr);
+                auto key = (session_key ? std::string(session_key) : std::string());
+                out << "tls " << to_hex(reinterpret_cast<const unsigned char*>(key.data()), key.size());
+                out << " " << to_hex(shmac, shmac_len) << " " << to_hex(sdata, sdata_len);
+                out << " " << static_cast<int64_t>(valid_until) << "\n";
+                return CURLE_OK;
+            }
+#endif // (LIBCURL_VERSION_NUM >= 0x080C00)
+
+            // hex encoding of binary session data; "-" denotes empty data
+            static std::string to_hex(const unsigned char* data, size_t size) {
+                static const char digits[] = "0123456789abcdef";
+                if(size == 0) { return "-"; }
+                auto res = std::string();
+                res.reserve(2 * size);
+                for(size_t i = 0; i < size; ++i) {
+                    res += digits[data[i] >> 4];
+                    res += digits[data[i] & 0x0f];
+                }
+                return res;
+            }
+
+            static std::vector<unsigned char> from_hex(std::string const& hex) {
+                auto res = std::vector<unsigned char>();
+                if(hex == "-") { return res; }
+                auto nibble = [](char c) { return static_cast<unsigned char>((c <= '9') ? (c - '0') : (c - 'a' + 10)); };
+                for(size_t i = 0; i + 1 < hex.size(); i += 2) {
+                    res.push_back(static_cast<unsigned char>((nibble(hex[i]) << 4) | nibble(hex[i + 1])));
+                }
+                return res;
+            }
+
         private:
+            // each kind of shared data gets its own lock, so that e.g. DNS
+            // lookups do not contend with cookie updates; the uncontended
+            // try_lock() path keeps the contention counting cheap
             static void lock_function_stub(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr) {
-                (void)handle; (void)data; (void)access;
+                (void)handle;
                 auto wrap = static_cast<curl_share_wrap*>(userptr); assert(wrap);
-                wrap->m_mutex.lock();
+                assert((0 <= data) && (data < CURL_LOCK_DATA_LAST));
+
+                auto& lock = wrap->m_locks[data];
+                if(access == CURL_LOCK_ACCESS_SHARED) {
+                    if(!lock.try_lock_shared()) {
+                        ++wrap->m_contention[data];
+                        lock.lock_shared();
+                    }
+                } else {
+                    if(!lock.try_lock()) {
+                        ++wrap->m_contention[data];
+                        lock.lock();
+                    }
+                }
             }
 
             static void unlock_function_stub(CURL* handle, curl_lock_data data, void* userptr) {
-                (void)handle; (void)data;
+                (void)handle;
                 auto wrap = static_cast<curl_share_wrap*>(userptr); assert(wrap);
-                wrap->m_mutex.unlock();
+                assert((0 <= data) && (data < CURL_LOCK_DATA_LAST));
+
+                // libcurl does not tell the access mode on unlocking
+                wrap->m_locks[data].unlock_any();
             }
-            
-            mutable std::mutex m_mutex;
-            CURLSH* const      m_share;
+
+            http::impl::rw_mutex    m_locks[CURL_LOCK_DATA_LAST];
+            std::atomic<size_t>     m_contention[CURL_LOCK_DATA_LAST];
+            CURLSH* const           m_share;
+
+            // host addresses preloaded by load() for the shared DNS cache;
+            // an easy handle might reference any of these lists until it
+            // gets reset, so they live as long as the share
+            std::mutex                  m_resolve_mutex;
+            std::vector<curl_slist*>    m_resolve;
+            std::atomic<bool>           m_resolve_pending;
+
+            const bool                                                  m_record_hosts;
+
+            // "host:port" => (address, time of the last successful use)
+            std::mutex                                                  m_hosts_mutex;
+            std::map<std::string, std::pair<std::string, std::time_t>> m_hosts;
+
+        private:
+            curl_share_wrap(curl_share_wrap const&); // = delete;
+            curl_share_wrap& operator=(curl_share_wrap const&); // = delete;
         };
 
     } // namespace impl
@@ -0,0 +1,325 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../executor.hpp"
+#include "../file_sink_options.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(WIN32)
+#   include <io.h>
+#   include <malloc.h>
+#else // defined(WIN32)
+#   include <fcntl.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif // defined(WIN32)
+
+namespace http {
+    namespace impl {
+
+        /// Writes the received data of a request to a file without
+        /// blocking the worker loop: the loop copies the data into large
+        /// aligned buffers which get written in order by a strand on the
+        /// writer thread pool. If all buffers are waiting to be written
+        /// write() refuses the data (which pauses the transfer) and
+        /// on_resume gets called once a buffer became available again.
+        struct file_sink :
+            public std::enable_shared_from_this<file_sink>
+        {
+            static const size_t ALIGNMENT = 4096;
+
+            /// Returns a nullptr if the file cannot be opened.
+            static std::shared_ptr<file_sink> open(std::string const& filename, http::file_sink_options const& options, std::shared_ptr<http::executor> writers) {
+                auto sink = std::shared_ptr<file_sink>(new file_sink(options, std::move(writers)));
+                return (sink->open_file(filename) ? sink : nullptr);
+            }
+
+            ~file_sink() {
+                close_file();
+                for(auto b : m_buffers) { free_aligned(b); }
+            }
+
+            /// Called without holding any lock; set before the transfer starts.
+            std::function<void()> on_resume;
+
+            /// Returns whether writing to the file failed.
+            bool failed() const { return m_failed; }
+
+            /// Copies the given data into the buffers; returns false without
+            /// copying anything if not enough buffers are available. Called
+            /// from the worker loop only.
+            bool write(const char* data, size_t size) {
+                // a chunk (at most CURL_MAX_WRITE_SIZE) spans up to two buffers
+                auto space = (m_current ? (m_buffer_size - m_current_used) : 0);
+                auto needed = ((size > space) ? ((size - space + m_buffer_size - 1) / m_buffer_size) : 0);
+                if(needed > 0) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(m_free.size() + (m_options.max_pending_buffers + 1 - m_buffers.size()) < needed) {
+                        m_paused = true;
+                        return false;
+                    }
+                }
+
+                while(size > 0) {
+                    if(!m_current) {
+                        m_current = take_buffer();
+                        m_current_used = 0;
+                    }
+                    auto n = std::min(size, m_buffer_size - m_current_used);
+                    std::memcpy(m_current + m_current_used, data, n);
+                    m_current_used += n;
+                    data += n;
+                    size -= n;
+                    if(m_current_used == m_buffer_size) { submit(); }
+                }
+                return true;
+            }
+
+            /// Reserves disk space for the given file size; only the first
+            /// call has an effect. Called from the worker loop only.
+            void preallocate(int64_t size) {
+                if(!m_options.preallocate || m_preallocated || (size <= 0)) { return; }
+                m_preallocated = true;
+#if defined(__linux__)
+                auto self = shared_from_this();
+                m_strand.post([self, size]() {
+                    // a failing reservation is no reason to fail the transfer
+                    auto res = ::posix_fallocate(self->m_fd, 0, static_cast<off_t>(size));
+                    (void)res;
+                });
+#endif // defined(__linux__)
+            }
+
+            /// Writes the remaining data, truncates the file to the written
+            /// size, optionally syncs it to the disk, and closes it; calls the
+            /// given function with the overall success from a writer thread.
+            /// Called from the worker loop only.
+            void close(std::function<void(bool)> done) {
+                auto size = m_offset + m_current_used;
+                if(m_current) { submit(); }
+
+                auto self = shared_from_this();
+                m_strand.post([self, size, done]() {
+                    self->finalize(size);
+                    done(!self->m_failed);
+                });
+            }
+
+        private:
+            file_sink(http::file_sink_options const& options, std::shared_ptr<http::executor> writers) :
+                m_options(options),
+                m_buffer_size(std::max<size_t>((options.buffer_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT, 64 * 1024)),
+                m_strand(std::move(writers)),
+                m_failed(false),
+                m_paused(false),
+                m_direct(false),
+                m_preallocated(false),
+                m_current(nullptr),
+                m_current_used(0),
+                m_offset(0),
+#if defined(WIN32)
+                m_file(nullptr)
+#else // defined(WIN32)
+                m_fd(-1)
+#endif // defined(WIN32)
+            {
+                m_options.max_pending_buffers = std::max<size_t>(m_options.max_pending_buffers, 1);
+            }
+
+            bool open_file(std::string const& filename) {
+#if defined(WIN32)
+                m_file = std::fopen(filename.c_str(), "wb");
+                return (m_file != nullptr);
+#else // defined(WIN32)
+                auto flags = (O_WRONLY | O_CREAT | O_TRUNC);
+#   if defined(__linux__)
+                if(m_options.direct_io) {
+                    m_fd = ::open(filename.c_str(), flags | O_DIRECT, 0666);
+                    m_direct = (m_fd != -1);
+                }
+#   endif // defined(__linux__)
+                if(m_fd == -1) { m_fd = ::open(filename.c_str(), flags, 0666); }
+                return (m_fd != -1);
+#endif // defined(WIN32)
+            }
+
+            void close_file() {
+#if defined(WIN32)
+                if(m_file) { std::fclose(m_file); m_file = nullptr; }
+#else // defined(WIN32)
+                if(m_fd != -1) { ::close(m_fd); m_fd = -1; }
+#endif // defined(WIN32)
+            }
+
+            char* take_buffer() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(!m_free.empty()) {
+                        auto b = m_free.back();
+                        m_free.pop_back();
+                        return b;
+                    }
+                }
+
+                auto b = alloc_aligned(m_buffer_size);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buffers.push_back(b);
+                return b;
+            }
+
+            /// Hands the current buffer over to the writer strand.
+            void submit() {
+                auto self   = shared_from_this();
+                auto buffer = m_current;
+                auto offset = m_offset;
+                auto used   = m_current_used;
+                m_strand.post([self, buffer, offset, used]() { self->write_buffer(buffer, offset, used); });
+
+                m_offset        += used;
+                m_current       = nullptr;
+                m_current_used  = 0;
+            }
+
+            /// Runs on the writer strand.
+            void write_buffer(char* buffer, uint64_t offset, size_t size) {
+                if(!m_failed) {
+#if defined(WIN32)
+                    m_failed = (std::fwrite(buffer, 1, size, m_file) != size);
+#else // defined(WIN32)
+                    auto length = size;
+                    if(m_direct) {
+                        // O_DIRECT requires whole blocks; the file gets truncated later
+                        length = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+                        std::memset(buffer + size, 0, length - size);
+                    }
+                    size_t written = 0;
+                    while(written < length) {
+                        auto res = ::pwrite(m_fd, buffer + written, length - written, static_cast<off_t>(offset + written));
+                        if(res < 0) {
+                            if(errno == EINTR) { continue; }
+                            m_failed = true;
+                            break;
+                        }
+                        written += static_cast<size_t>(res);
+                    }
+#endif // defined(WIN32)
+                }
+
+                // the buffer is available again
+                auto resume = false;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_free.push_back(buffer);
+                    resume = m_paused;
+                    m_paused = false;
+                }
+                if(resume && on_resume) { on_resume(); }
+            }
+
+            /// Runs on the writer strand.
+            void finalize(uint64_t size) {
+#if defined(WIN32)
+                if(m_file) {
+                    if(std::fflush(m_file) != 0) { m_failed = true; }
+                    if(m_options.durable && (_commit(_fileno(m_file)) != 0)) { m_failed = true; }
+                }
+#else // defined(WIN32)
+                if((m_direct || m_preallocated) && (::ftruncate(m_fd, static_cast<off_t>(size)) != 0)) {
+                    m_failed = true;
+                }
+                if(m_options.durable && (::fdatasync(m_fd) != 0)) {
+                    m_failed = true;
+                }
+#endif // defined(WIN32)
+                (void)size;
+                close_file();
+            }
+
+            static char* alloc_aligned(size_t size) {
+#if defined(WIN32)
+                auto p = _aligned_malloc(size, ALIGNMENT);
+#else // defined(WIN32)
+                void* p = nullptr;
+                if(::posix_memalign(&p, ALIGNMENT, size) != 0) { p = nullptr; }
+#endif // defined(WIN32)
+                if(!p) { throw std::bad_alloc(); }
+                return static_cast<char*>(p);
+            }
+
+            static void free_aligned(char* p) {
+#if defined(WIN32)
+                _aligned_free(p);
+#else // defined(WIN32)
+                std::free(p);
+#endif // defined(WIN32)
+            }
+
+            http::file_sink_options     m_options;
+            size_t const                m_buffer_size;
+            http::strand                m_strand;
+
+            std::atomic<bool>           m_failed;
+
+            // the free and all allocated buffers; guarded by m_mutex
+            std::mutex                  m_mutex;
+            std::vector<char*>          m_free;
+            std::vector<char*>          m_buffers;
+            bool                        m_paused;
+
+            bool                        m_direct;
+            bool                        m_preallocated;
+
+            // the buffer currently getting filled by the worker loop
+            char*                       m_current;
+            size_t                      m_current_used;
+            uint64_t                    m_offset;
+
+#if defined(WIN32)
+            FILE*                       m_file;
+#else // defined(WIN32)
+            int                         m_fd;
+#endif // defined(WIN32)
+
+        private:
+            file_sink(file_sink const&); // = delete;
+            file_sink& operator=(file_sink const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
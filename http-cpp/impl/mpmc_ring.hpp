@@ -0,0 +1,134 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace http {
+    namespace impl {
+
+        /// A bounded lock-free multi-producer/multi-consumer queue (see:
+        /// D. Vyukov, "Bounded MPMC queue"). The capacity gets rounded up
+        /// to a power of two; push() fails instead of blocking if the ring
+        /// is full and pop() fails if it is empty.
+        template<typename T>
+        struct mpmc_ring {
+            explicit mpmc_ring(size_t capacity) :
+                m_cells(round_up(capacity)),
+                m_mask(m_cells.size() - 1),
+                m_enqueue_pos(0),
+                m_dequeue_pos(0)
+            {
+                for(size_t i = 0; i < m_cells.size(); ++i) {
+                    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            size_t capacity() const { return m_cells.size(); }
+
+            bool push(T& value) {
+                auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                for(;;) {
+                    auto& cell = m_cells[pos & m_mask];
+                    auto seq = cell.sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                    if(diff == 0) {
+                        if(m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            cell.value = std::move(value);
+                            cell.sequence.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if(diff < 0) {
+                        return false; // full
+                    } else {
+                        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            bool pop(T& value) {
+                auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                for(;;) {
+                    auto& cell = m_cells[pos & m_mask];
+                    auto seq = cell.sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                    if(diff == 0) {
+                        if(m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            value = std::move(cell.value);
+                            cell.value = T();
+                            cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if(diff < 0) {
+                        return false; // empty
+                    } else {
+                        pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            /// Returns whether there is no element ready for pop(); unlike
+            /// size() this does not count elements whose push() is still
+            /// in progress.
+            bool empty() const {
+                auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                auto seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+                return ((static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1)) < 0);
+            }
+
+            /// Returns an approximation of the number of stored elements.
+            size_t size() const {
+                auto enqueued = m_enqueue_pos.load(std::memory_order_relaxed);
+                auto dequeued = m_dequeue_pos.load(std::memory_order_relaxed);
+                return (enqueued > dequeued) ? (enqueued - dequeued) : 0;
+            }
+
+        private:
+            static size_t round_up(size_t n) {
+                size_t c = 2;
+                while(c < n) { c *= 2; }
+                return c;
+            }
+
+            struct cell {
+                std::atomic<size_t> sequence;
+                T                   value;
+            };
+
+            // keep producers and consumers on different cache lines
+            std::vector<cell>   m_cells;
+            size_t const        m_mask;
+            alignas(64) std::atomic<size_t> m_enqueue_pos;
+            alignas(64) std::atomic<size_t> m_dequeue_pos;
+
+        private:
+            mpmc_ring(mpmc_ring const&); // = delete;
+            mpmc_ring& operator=(mpmc_ring const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
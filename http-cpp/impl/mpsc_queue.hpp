@@ -0,0 +1,90 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include <atomic>
+
+namespace http {
+    namespace impl {
+
+        /// An unbounded lock-free multi-producer/single-consumer queue
+        /// (see: D. Vyukov, "Non-intrusive MPSC node-based queue").
+        /// push() can be called from any thread while pop() and empty()
+        /// must only be called from the single consumer thread.
+        template<typename T>
+        struct mpsc_queue {
+            mpsc_queue() :
+                m_head(new node()),
+                m_tail(m_head.load())
+            { }
+
+            ~mpsc_queue() {
+                T value;
+                while(pop(value)) { }
+                delete m_tail;
+            }
+
+            void push(T value) {
+                auto n = new node(std::move(value));
+                auto prev = m_head.exchange(n);
+                prev->next.store(n, std::memory_order_release);
+            }
+
+            bool pop(T& value) {
+                auto tail = m_tail;
+                auto next = tail->next.load(std::memory_order_acquire);
+                if(!next) { return false; } // empty or a push is not fully linked yet
+
+                value = std::move(next->value);
+                next->value = T();
+                m_tail = next;
+                delete tail;
+                return true;
+            }
+
+            /// Returns false also if a push is still in progress, so that
+            /// the consumer does not block while an element is underway.
+            bool empty() const {
+                return (m_head.load() == m_tail);
+            }
+
+        private:
+            struct node {
+                node() : next(nullptr) { }
+                explicit node(T v) : value(std::move(v)), next(nullptr) { }
+
+                T                   value;
+                std::atomic<node*>  next;
+            };
+
+            std::atomic<node*>  m_head; // producers push here
+            node*               m_tail; // consumer pops here
+
+        private:
+            mpsc_queue(mpsc_queue const&); // = delete;
+            mpsc_queue& operator=(mpsc_queue const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
@@ -0,0 +1,160 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "../memory_resource.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace http {
+    namespace impl {
+
+        /// A monotonic arena holding the bookkeeping of a single request
+        /// (the request object itself and the shared state of its future);
+        /// the data owned by the request (URL, callbacks, headers, body)
+        /// does not go through it.
+        /// Memory is handed out by bumping a pointer and never reused; the
+        /// arena frees all its blocks in one step once every allocation
+        /// made from it has been released again. Allocations and releases
+        /// can happen from any thread.
+        struct request_arena {
+            /// Creates a new arena with an initial block of the given size
+            /// taken from the given upstream resource (or from the global
+            /// operator new if null); the returned arena holds one reference
+            /// which needs to be released by the caller.
+            static request_arena* create(size_t block_size, std::shared_ptr<http::memory_resource> upstream) {
+                block_size = std::max(block_size, sizeof(request_arena) + sizeof(block) + 256);
+                auto mem = allocate_block(upstream.get(), block_size);
+                auto b = ::new(mem) block(block_size);
+                return ::new(b + 1) request_arena(b, std::move(upstream));
+            }
+
+            void* allocate(size_t bytes, size_t alignment) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto p = align(m_current, alignment);
+                if(p + bytes > m_end) {
+                    add_block(bytes + alignment);
+                    p = align(m_current, alignment);
+                }
+                m_current = p + bytes;
+                retain();
+                return p;
+            }
+
+            void deallocate(void*, size_t) {
+                release();
+            }
+
+            void retain() { m_refs.fetch_add(1, std::memory_order_relaxed); }
+
+            void release() {
+                if(m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    destroy();
+                }
+            }
+
+        private:
+            struct block {
+                explicit block(size_t s) : next(nullptr), size(s) { }
+                block*  next;
+                size_t  size;
+            };
+
+            request_arena(block* first, std::shared_ptr<http::memory_resource> upstream) :
+                m_mutex(),
+                m_refs(1),
+                m_current(reinterpret_cast<char*>(this + 1)),
+                m_end(reinterpret_cast<char*>(first) + first->size),
+                m_blocks(first),
+                m_block_size(first->size),
+                m_upstream(std::move(upstream))
+            { }
+
+            static char* align(char* p, size_t alignment) {
+                auto addr = reinterpret_cast<uintptr_t>(p);
+                return reinterpret_cast<char*>((addr + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+            }
+
+            static void* allocate_block(http::memory_resource* upstream, size_t size) {
+                return (upstream ? upstream->allocate(size, alignof(std::max_align_t)) : ::operator new(size));
+            }
+
+            static void deallocate_block(http::memory_resource* upstream, void* p, size_t size) {
+                if(upstream) { upstream->deallocate(p, size, alignof(std::max_align_t)); } else { ::operator delete(p); }
+            }
+
+            void add_block(size_t min_bytes) {
+                auto size = std::max(m_block_size, min_bytes + sizeof(block));
+                auto b = ::new(allocate_block(m_upstream.get(), size)) block(size);
+                b->next = m_blocks->next; // keep the first block (holding this arena) at the front
+                m_blocks->next = b;
+                m_current = reinterpret_cast<char*>(b + 1);
+                m_end = reinterpret_cast<char*>(b) + size;
+            }
+
+            void destroy() {
+                auto upstream = std::move(m_upstream);
+                auto b = m_blocks;
+                this->~request_arena();
+                while(b) {
+                    auto next = b->next;
+                    deallocate_block(upstream.get(), b, b->size);
+                    b = next;
+                }
+            }
+
+            std::mutex                              m_mutex;
+            std::atomic<size_t>                     m_refs;
+            char*                                   m_current;
+            char*                                   m_end;
+            block*                                  m_blocks;
+            size_t const                            m_block_size;
+            std::shared_ptr<http::memory_resource>  m_upstream;
+        };
+
+        /// A standard allocator allocating from a request_arena.
+        template<typename T>
+        struct arena_allocator {
+            typedef T value_type;
+
+            explicit arena_allocator(request_arena* arena) : arena(arena) { }
+            template<typename U> arena_allocator(arena_allocator<U> const& other) : arena(other.arena) { }
+
+            T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+            void deallocate(T* p, size_t n) { arena->deallocate(p, n * sizeof(T)); }
+
+            template<typename U> friend bool operator==(arena_allocator const& lhs, arena_allocator<U> const& rhs) { return (lhs.arena == rhs.arena); }
+            template<typename U> friend bool operator!=(arena_allocator const& lhs, arena_allocator<U> const& rhs) { return (lhs.arena != rhs.arena); }
+
+            request_arena* arena;
+        };
+
+    } // namespace impl
+} // namespace http
@@ -0,0 +1,96 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+#pragma once
+
+#if defined(WIN32)
+#   include <windows.h>
+#else // defined(WIN32)
+#   include <pthread.h>
+#endif // defined(WIN32)
+
+namespace http {
+    namespace impl {
+
+        /// A reader-writer lock (C++11 lacks std::shared_mutex) on top of
+        /// the native one, so that shared owners never serialize on an
+        /// internal mutex. Besides the usual interface it offers
+        /// unlock_any() for callers which do not know in which mode they
+        /// acquired the lock (e.g., libcurl's unlock callback). Waiting
+        /// writers are preferred over new readers where the platform
+        /// supports it (glibc).
+        struct rw_mutex {
+#if defined(WIN32)
+            rw_mutex() : m_exclusive(false) { InitializeSRWLock(&m_lock); }
+
+            void lock()             { AcquireSRWLockExclusive(&m_lock); m_exclusive = true; }
+            bool try_lock()         { if(!TryAcquireSRWLockExclusive(&m_lock)) { return false; } m_exclusive = true; return true; }
+            void unlock()           { m_exclusive = false; ReleaseSRWLockExclusive(&m_lock); }
+            void lock_shared()      { AcquireSRWLockShared(&m_lock); }
+            bool try_lock_shared()  { return (TryAcquireSRWLockShared(&m_lock) != 0); }
+            void unlock_shared()    { ReleaseSRWLockShared(&m_lock); }
+
+            /// Releases the lock held by the calling thread, either
+            /// exclusively or shared; while a writer holds the lock
+            /// there cannot be any readers, so the flag is unambiguous.
+            void unlock_any()       { if(m_exclusive) { unlock(); } else { unlock_shared(); } }
+#else // defined(WIN32)
+            rw_mutex() {
+                pthread_rwlockattr_t attr;
+                pthread_rwlockattr_init(&attr);
+#if defined(__GLIBC__)
+                pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif // defined(__GLIBC__)
+                pthread_rwlock_init(&m_lock, &attr);
+                pthread_rwlockattr_destroy(&attr);
+            }
+
+            ~rw_mutex() { pthread_rwlock_destroy(&m_lock); }
+
+            void lock()             { pthread_rwlock_wrlock(&m_lock); }
+            bool try_lock()         { return (pthread_rwlock_trywrlock(&m_lock) == 0); }
+            void unlock()           { pthread_rwlock_unlock(&m_lock); }
+            void lock_shared()      { pthread_rwlock_rdlock(&m_lock); }
+            bool try_lock_shared()  { return (pthread_rwlock_tryrdlock(&m_lock) == 0); }
+            void unlock_shared()    { pthread_rwlock_unlock(&m_lock); }
+
+            /// Releases the lock held by the calling thread, either
+            /// exclusively or shared; pthread_rwlock_unlock() knows the
+            /// mode by itself.
+            void unlock_any()       { pthread_rwlock_unlock(&m_lock); }
+#endif // defined(WIN32)
+
+        private:
+#if defined(WIN32)
+            SRWLOCK             m_lock;
+            bool                m_exclusive;
+#else // defined(WIN32)
+            pthread_rwlock_t    m_lock;
+#endif // defined(WIN32)
+
+        private:
+            rw_mutex(rw_mutex const&); // = delete;
+            rw_mutex& operator=(rw_mutex const&); // = delete;
+        };
+
+    } // namespace impl
+} // namespace http
@@ -0,0 +1,170 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace http {
+
+    /// The engine used by a worker loop for waiting on socket activity.
+    enum loop_engine {
+        /// Uses curl_multi_perform() and curl_multi_poll(); each loop
+        /// iteration visits all transfers of the loop.
+        HTTP_LOOP_ENGINE_POLL,
+
+        /// Uses curl_multi_socket_action() driven by epoll; each loop
+        /// iteration only visits the transfers with ready sockets or
+        /// expired timeouts. Suited for many concurrent but mostly idle
+        /// transfers (e.g., long-polling). Only available on Linux; other
+        /// platforms fall back to HTTP_LOOP_ENGINE_POLL.
+        HTTP_LOOP_ENGINE_EPOLL
+    };
+
+    /// The policy used to assign a new request to one of the worker loops.
+    enum loop_policy {
+        /// Assigns all requests for the same scheme, host, and port to the
+        /// same loop in order to keep the connection reuse of that loop.
+        HTTP_LOOP_POLICY_HOST_HASH,
+
+        /// Assigns a request to the loop with the fewest active requests.
+        HTTP_LOOP_POLICY_LEAST_LOADED,
+
+        /// Assigns the requests to the loops in turn.
+        HTTP_LOOP_POLICY_ROUND_ROBIN
+    };
+
+    /// Configures the worker loop(s) sending and receiving the data for
+    /// all requests; see http::client::configure().
+    struct loop_options {
+        loop_options() :
+            engine(HTTP_LOOP_ENGINE_POLL),
+            loop_count(1),
+            policy(HTTP_LOOP_POLICY_HOST_HASH),
+            easy_handle_pool_size(64),
+            multiplex(false),
+            max_concurrent_streams(100),
+            max_total_connections(0),
+            max_host_connections(0),
+            max_cached_connections(0),
+            max_active_requests(0),
+            receive_buffer_budget(0),
+            file_writer_threads(2),
+            share_connections(false),
+            record_session_hosts(false)
+        { }
+
+        /// The engine used for waiting on socket activity. The default
+        /// value is HTTP_LOOP_ENGINE_POLL.
+        http::loop_engine engine;
+
+        /// The number of independent worker loops; each loop runs in its
+        /// own thread and has its own connection cache. The default value
+        /// is 1.
+        size_t loop_count;
+
+        /// The policy for assigning new requests to one of the loops. The
+        /// default value is HTTP_LOOP_POLICY_HOST_HASH.
+        http::loop_policy policy;
+
+        /// If provided this callback replaces the policy above: it gets
+        /// called with the URL of a new request and the current number of
+        /// active requests per loop and returns the index of the loop the
+        /// request should be assigned to. The callback gets called from
+        /// the thread starting the request.
+        std::function<size_t(std::string const& url, std::vector<size_t> const& active_requests)> select_loop;
+
+        /// The maximum number of finished easy handles each loop keeps for
+        /// reuse by new requests (after resetting them via curl_easy_reset());
+        /// 0 disables the reuse. The default value is 64.
+        size_t easy_handle_pool_size;
+
+        /// Allows multiple HTTP/2 requests to the same host to share a
+        /// single connection as separate streams, instead of opening one
+        /// connection per concurrent request. Requires libcurl >= 7.43.0
+        /// and a request protocol negotiating HTTP/2 (see
+        /// http::client::protocol). The default value is false.
+        bool multiplex;
+
+        /// The maximum number of concurrent streams per multiplexed
+        /// HTTP/2 connection; the server might announce a lower limit.
+        /// Requires libcurl >= 7.67.0. The default value is 100.
+        size_t max_concurrent_streams;
+
+        /// The maximum number of simultaneously open connections of each
+        /// loop; additional transfers wait inside libcurl for a connection
+        /// to become available. Requires libcurl >= 7.30.0. The default
+        /// value is 0 (unlimited).
+        size_t max_total_connections;
+
+        /// The maximum number of simultaneously open connections of each
+        /// loop to a single host. Requires libcurl >= 7.30.0. The default
+        /// value is 0 (unlimited).
+        size_t max_host_connections;
+
+        /// The maximum number of idle connections each loop keeps open
+        /// for reuse by later requests. The default value is 0 which uses
+        /// the libcurl default (4 times the number of active transfers).
+        size_t max_cached_connections;
+
+        /// The maximum number of requests each loop hands over to libcurl
+        /// at the same time; further requests wait in the admission queue
+        /// of the loop, in order, until a running request finishes. See
+        /// http::request::queue_depth() and http::request::queue_wait_time().
+        /// The default value is 0 (unlimited).
+        size_t max_active_requests;
+
+        /// The maximum number of received bytes all requests together
+        /// may have queued for their callbacks on a callback executor
+        /// (see http::client::receive_buffer_limit); a request exceeding
+        /// it gets paused until its consumer caught up. Each request can
+        /// queue at least one chunk though, so that it cannot stall. The
+        /// default value is 0 (unlimited).
+        size_t receive_buffer_budget;
+
+        /// The number of threads writing the data of the receive files of
+        /// all requests (see http::file_sink_options::async); the pool gets
+        /// created on first use. The default value is 2.
+        size_t file_writer_threads;
+
+        /// Lets all loops share a single connection cache, so that a
+        /// connection opened by one loop can get reused by requests of the
+        /// other loops instead of paying for a new TCP and TLS handshake
+        /// per loop. This comes at the cost of a lock around the cache.
+        /// Requires libcurl >= 7.57.0. The default value is false.
+        bool share_connections;
+
+        /// Records the host address of each successfully finished request
+        /// for http::client::save_session_cache(). This costs a URL parse
+        /// and a lock per finished request on the loop threads, so it is
+        /// opt-in; without it only the TLS sessions get saved. Requires
+        /// libcurl >= 7.62.0. The default value is false.
+        bool record_session_hosts;
+    };
+
+} // namespace http
@@ -0,0 +1,88 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <cstddef>
+
+namespace http {
+
+    /// Counters collected by the worker loop(s); see http::client::statistics().
+    struct loop_statistics {
+        loop_statistics() :
+            easy_handle_pool_hits(0),
+            easy_handle_pool_misses(0),
+            new_connections(0),
+            reused_connections(0),
+            queued_requests(0),
+            resumed_transfers(0),
+            share_lock_contention_cookie(0),
+            share_lock_contention_dns(0),
+            share_lock_contention_ssl_session(0),
+            share_lock_contention_connect(0)
+        { }
+
+        /// The number of requests which reused a recycled easy handle.
+        size_t easy_handle_pool_hits;
+
+        /// The number of requests which needed to create a new easy handle.
+        size_t easy_handle_pool_misses;
+
+        /// The number of new connections opened by the finished requests.
+        size_t new_connections;
+
+        /// The number of finished requests which reused an already open
+        /// connection; the connection reuse ratio is therefore given by
+        /// reused_connections / (reused_connections + new_connections).
+        size_t reused_connections;
+
+        /// The number of requests which had to wait in the admission queue
+        /// of a loop; see http::loop_options::max_active_requests.
+        size_t queued_requests;
+
+        /// The number of times a transfer paused by the flow control of
+        /// its receive buffer got resumed; see
+        /// http::client::receive_buffer_limit.
+        size_t resumed_transfers;
+
+        /// The number of times a transfer had to wait for the lock
+        /// protecting the cookies shared between all requests.
+        size_t share_lock_contention_cookie;
+
+        /// The number of times a transfer had to wait for the lock
+        /// protecting the shared DNS cache.
+        size_t share_lock_contention_dns;
+
+        /// The number of times a transfer had to wait for the lock
+        /// protecting the shared TLS session cache.
+        size_t share_lock_contention_ssl_session;
+
+        /// The number of times a transfer had to wait for the lock
+        /// protecting the shared connection cache (see
+        /// http::loop_options::share_connections).
+        size_t share_lock_contention_connect;
+    };
+
+} // namespace http
@@ -0,0 +1,70 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./http-cpp.hpp"
+
+#include <cstddef>
+
+#if defined(__has_include)
+#   if __has_include(<memory_resource>) && (__cplusplus >= 201703L)
+#       include <memory_resource>
+#   endif
+#endif // defined(__has_include)
+
+namespace http {
+
+    /// The source of the memory blocks of the per-request arenas (see
+    /// http::client::memory_resource); mirrors the interface of C++17's
+    /// std::pmr::memory_resource so that the library does not depend on
+    /// C++17. Implementations need to be thread-safe since the blocks get
+    /// released from the context of whichever thread drops the last
+    /// reference to a request.
+    struct HTTP_API memory_resource {
+        virtual ~memory_resource() { }
+
+        void* allocate(size_t bytes, size_t alignment) { return do_allocate(bytes, alignment); }
+        void deallocate(void* p, size_t bytes, size_t alignment) { do_deallocate(p, bytes, alignment); }
+
+    protected:
+        virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+        virtual void do_deallocate(void* p, size_t bytes, size_t alignment) = 0;
+    };
+
+#if defined(__cpp_lib_memory_resource)
+    /// Forwards to a std::pmr::memory_resource, which needs to outlive
+    /// all requests using it.
+    struct pmr_memory_resource : http::memory_resource {
+        explicit pmr_memory_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) : m_upstream(upstream) { }
+
+    protected:
+        virtual void* do_allocate(size_t bytes, size_t alignment) override { return m_upstream->allocate(bytes, alignment); }
+        virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override { m_upstream->deallocate(p, bytes, alignment); }
+
+    private:
+        std::pmr::memory_resource* m_upstream;
+    };
+#endif // defined(__cpp_lib_memory_resource)
+
+} // namespace http
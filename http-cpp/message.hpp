@@ -23,7 +23,10 @@
 
 #pragma once
 
+#include "./buffer.hpp"
 #include "./error_code.hpp"
+#include "./headers.hpp"
+#include "./segmented_buffer.hpp"
 #include "./status.hpp"
 
 #include <map>
@@ -32,8 +35,6 @@
 
 namespace http {
 
-    typedef std::string buffer;
-    typedef std::map<std::string, std::string> headers;
     typedef std::map<std::string, std::string> parameters;
 
     struct message {
@@ -48,7 +49,8 @@ namespace http {
             error_string(std::move(es)),
             status(s),
             headers(std::move(h)),
-            body(std::move(b))
+            body(std::move(b)),
+            segmented_body()
         { }
 
         http::error_code    error_code;
@@ -57,6 +59,10 @@ namespace http {
         http::headers       headers;
         http::buffer        body;
 
+        /// Holds the received data instead of body if the request has
+        /// been started with client::segmented_body set.
+        http::segmented_buffer segmented_body;
+
 #if defined(HTTP_CPP_NEED_EXPLICIT_MOVE)
         message(message&& o) HTTP_CPP_NOEXCEPT { operator=(std::move(o)); }
         message& operator=(message&& o) HTTP_CPP_NOEXCEPT {
@@ -66,6 +72,7 @@ namespace http {
                 status          = std::move(o.status);
                 headers         = std::move(o.headers);
                 body            = std::move(o.body);
+                segmented_body  = std::move(o.segmented_body);
             }
             return *this;
         }
@@ -23,11 +23,13 @@
 
 #pragma once
 
+#include "./body_stream.hpp"
 #include "./message.hpp"
 #include "./operation.hpp"
 #include "./progress.hpp"
 #include "./utils.hpp"
 
+#include <chrono>
 #include <future>
 
  // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
@@ -41,25 +43,84 @@ namespace http {
     typedef std::string url;
 
     struct HTTP_API request {
+        /// Returns a future for the resulting message. The future gets
+        /// created on the first call only; use result() or the waiting
+        /// methods in order to avoid its overhead.
         std::shared_future<http::message>& data();
 
+        /// Waits for the request to finish and returns the resulting
+        /// message without involving a future; the reference stays
+        /// valid as long as this request object exists.
+        http::message const& result();
+
+        /// Waits for the request to finish and moves the resulting
+        /// message out of it; it only gets copied if data() or result()
+        /// exposed it before. Meant for the last user of a request, as
+        /// the message is gone from this request object afterwards.
+        http::message take_result();
+
+        /// Returns whether the resulting message is available.
+        bool ready() const;
+
+        /// Registers a function to be called once with the given context
+        /// after the request finished (including the on_finish callback),
+        /// from the context of the finishing thread. This is an allocation
+        /// free hook for adapters such as the coroutine support in
+        /// coroutine.hpp; only a single continuation can be registered.
+        /// Returns false without registering anything if the resulting
+        /// message is available already.
+        bool set_continuation(void (*continuation)(void* context), void* context);
+
         http::url url() const;
         http::operation operation() const;
 
         http::progress progress() const;
 
-        void cancel();
+        /// Returns the number of requests which were already waiting in
+        /// the admission queue of the worker loop when this request got
+        /// queued; 0 if it did not need to wait at all. See
+        /// http::loop_options::max_active_requests.
+        size_t queue_depth() const;
 
-        inline void wait() { http::wait(data()); }
+        /// Returns the time this request spent between getting started
+        /// and getting handed over to libcurl by the worker loop; this is
+        /// mostly the time waiting in the admission queue. Only valid once
+        /// the request left the queue.
+        std::chrono::steady_clock::duration queue_wait_time() const;
 
-        template<typename TIME>
-        inline auto wait_for(TIME&& t) -> decltype(std::future_status::ready) {
-            return http::wait_for(data(), std::forward<TIME>(t));
+        void cancel();
+
+        /// Returns a reader for the body of this request if it got
+        /// started with http::client::body_stream_size set; an invalid
+        /// reader otherwise. All readers of a request share the same
+        /// data; once the last one is gone the remaining body data gets
+        /// discarded and further calls return a reader at its end.
+        http::body_stream stream();
+
+        /// Continues a transfer which got paused because its consumer
+        /// fell behind (see http::client::receive_buffer_limit); this
+        /// happens automatically once the consumer drained the queued
+        /// data. A transfer gets paused again right away if the consumer
+        /// is still behind.
+        void resume();
+
+        /// Waits for the resulting message to be available.
+        void wait();
+
+        /// Waits for the resulting message using the given timeout duration.
+        template<typename DURATION>
+        inline std::future_status wait_for(DURATION const& duration) {
+            return wait_until(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration));
         }
 
-        template<typename TIME>
-        inline auto wait_until(TIME&& t) -> decltype(std::future_status::ready) {
-            return http::wait_until(data(), std::forward<TIME>(t));
+        /// Waits for the resulting message using the given absolute timeout time.
+        std::future_status wait_until(std::chrono::steady_clock::time_point timeout_time);
+
+        /// Waits for the resulting message using the given absolute
+        /// timeout time of an arbitrary clock (e.g., std::chrono::system_clock).
+        template<typename CLOCK, typename DURATION>
+        inline std::future_status wait_until(std::chrono::time_point<CLOCK, DURATION> const& timeout_time) {
+            return wait_for(timeout_time - CLOCK::now());
         }
 
     private:
@@ -0,0 +1,151 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./segmented_buffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+
+const size_t http::segmented_buffer::segment_size;
+
+namespace {
+
+    /// The process-wide free list of body segments.
+    struct segment_pool {
+        segment_pool() : m_limit(256) { }
+
+        char* acquire() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(!m_free.empty()) {
+                    auto s = m_free.back();
+                    m_free.pop_back();
+                    return s;
+                }
+            }
+            return new char[http::segmented_buffer::segment_size];
+        }
+
+        void release(std::vector<char*>& segments) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for(auto&& s : segments) {
+                if(m_free.size() < m_limit) {
+                    m_free.push_back(s);
+                } else {
+                    delete[] s;
+                }
+            }
+            segments.clear();
+        }
+
+        void set_limit(size_t limit) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_limit = limit;
+            while(m_free.size() > m_limit) {
+                delete[] m_free.back();
+                m_free.pop_back();
+            }
+        }
+
+        size_t size() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_free.size();
+        }
+
+    private:
+        std::mutex          m_mutex;
+        std::vector<char*>  m_free;
+        size_t              m_limit;
+    };
+
+    // intentionally leaked, so that buffers destroyed during static
+    // deinitialization can still return their segments
+    segment_pool& pool() {
+        static segment_pool* instance = new segment_pool();
+        return *instance;
+    }
+
+} // namespace
+
+http::segmented_buffer::segmented_buffer(segmented_buffer const& other) :
+    m_size(0)
+{
+    for(size_t i = 0; i < other.segment_count(); ++i) {
+        auto s = other.segment(i);
+        append(s.data(), s.size());
+    }
+}
+
+http::segmented_buffer::segmented_buffer(segmented_buffer&& other) HTTP_CPP_NOEXCEPT :
+    m_segments(std::move(other.m_segments)),
+    m_size(other.m_size)
+{
+    other.m_segments.clear();
+    other.m_size = 0;
+}
+
+http::segmented_buffer& http::segmented_buffer::operator=(segmented_buffer other) HTTP_CPP_NOEXCEPT {
+    std::swap(m_segments, other.m_segments);
+    std::swap(m_size, other.m_size);
+    return *this;
+}
+
+void http::segmented_buffer::append(const char* data, size_t bytes) {
+    while(bytes > 0) {
+        auto used = m_size % segment_size;
+        if(used == 0) { m_segments.push_back(pool().acquire()); }
+
+        auto n = std::min(bytes, segment_size - used);
+        std::memcpy(m_segments.back() + used, data, n);
+
+        data    += n;
+        bytes   -= n;
+        m_size  += n;
+    }
+}
+
+void http::segmented_buffer::clear() {
+    pool().release(m_segments);
+    m_size = 0;
+}
+
+http::buffer_view http::segmented_buffer::segment(size_t index) const {
+    assert(index < m_segments.size());
+    auto offset = index * segment_size;
+    return http::buffer_view(m_segments[index], std::min(segment_size, m_size - offset));
+}
+
+http::buffer http::segmented_buffer::flatten() const {
+    http::buffer flat;
+    flat.reserve(m_size);
+    for(size_t i = 0; i < segment_count(); ++i) {
+        auto s = segment(i);
+        flat.append(s.data(), s.size());
+    }
+    return flat;
+}
+
+void http::segmented_buffer::set_pool_limit(size_t segments) { pool().set_limit(segments); }
+size_t http::segmented_buffer::pooled_segments() { return pool().size(); }
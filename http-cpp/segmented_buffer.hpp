@@ -0,0 +1,117 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./buffer.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    /// A body buffer made of fixed-size segments instead of a single
+    /// contiguous block: appending never reallocates or moves already
+    /// stored data, and the segments get recycled through a process-wide
+    /// pool once a buffer releases them, which keeps the memory usage of
+    /// repeated large downloads steady. The data can be accessed segment
+    /// by segment (scatter-gather), byte by byte via iterators, or be
+    /// flattened into a contiguous http::buffer on demand.
+    struct HTTP_API segmented_buffer {
+        /// The size of each segment in bytes.
+        static const size_t segment_size = 64 * 1024;
+
+        segmented_buffer() : m_size(0) { }
+        segmented_buffer(segmented_buffer const& other);
+        segmented_buffer(segmented_buffer&& other) HTTP_CPP_NOEXCEPT;
+        segmented_buffer& operator=(segmented_buffer other) HTTP_CPP_NOEXCEPT;
+        ~segmented_buffer() { clear(); }
+
+        /// Appends the given data, filling up the last segment first.
+        void append(const char* data, size_t bytes);
+
+        /// Returns all segments to the pool.
+        void clear();
+
+        size_t  size()  const { return m_size; }
+        bool    empty() const { return (m_size == 0); }
+
+        /// Scatter-gather access to the stored data; only the last segment
+        /// might be filled partially.
+        size_t              segment_count() const { return m_segments.size(); }
+        http::buffer_view   segment(size_t index) const;
+
+        /// Copies the stored data into a contiguous buffer.
+        http::buffer flatten() const;
+
+        /// A forward iterator over the stored bytes.
+        struct const_iterator {
+            typedef std::forward_iterator_tag   iterator_category;
+            typedef char                        value_type;
+            typedef std::ptrdiff_t              difference_type;
+            typedef const char*                 pointer;
+            typedef const char&                 reference;
+
+            const_iterator(segmented_buffer const* buffer = nullptr, size_t pos = 0) : m_buffer(buffer), m_pos(pos) { }
+
+            reference operator*() const { return m_buffer->m_segments[m_pos / segment_size][m_pos % segment_size]; }
+
+            const_iterator& operator++() { ++m_pos; return *this; }
+            const_iterator  operator++(int) { auto tmp = *this; ++m_pos; return tmp; }
+
+            friend bool operator==(const_iterator const& lhs, const_iterator const& rhs) { return (lhs.m_pos == rhs.m_pos); }
+            friend bool operator!=(const_iterator const& lhs, const_iterator const& rhs) { return (lhs.m_pos != rhs.m_pos); }
+
+        private:
+            segmented_buffer const* m_buffer;
+            size_t                  m_pos;
+        };
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end()   const { return const_iterator(this, m_size); }
+
+        /// Limits the number of unused segments kept by the process-wide
+        /// pool (default 256 segments, i.e., 16 MiB); surplus segments get
+        /// freed.
+        static void set_pool_limit(size_t segments);
+
+        /// Returns the number of unused segments currently kept by the pool.
+        static size_t pooled_segments();
+
+    private:
+        std::vector<char*>  m_segments;
+        size_t              m_size;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
@@ -0,0 +1,209 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "./thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct http::thread_pool::state {
+    struct queue {
+        std::mutex                          mutex;
+        std::deque<std::function<void()>>   tasks;
+    };
+
+    explicit state(size_t n) :
+        queues(n),
+        pending(0),
+        pushes(0),
+        next(0),
+        sleepers(0),
+        steals(0),
+        stop(false)
+    {
+        for(auto&& q : queues) { q.reset(new queue()); }
+    }
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread>            workers;
+
+    std::atomic<size_t>                 pending;    // queued but not yet started tasks
+    std::atomic<size_t>                 pushes;     // ever queued tasks; sleeping workers wait for a change
+    std::atomic<size_t>                 next;       // round-robin index for external posts
+    std::atomic<size_t>                 sleepers;
+    std::atomic<size_t>                 steals;
+    std::atomic<bool>                   stop;
+
+    std::mutex                          sleep_mutex;
+    std::condition_variable             wakeup;
+
+    /// The pool and the queue index of the current worker thread.
+    static state*& current()        { static thread_local state* s = nullptr; return s; }
+    static size_t& current_index()  { static thread_local size_t i = 0; return i; }
+
+    void push(size_t index, std::function<void()> task) {
+        {
+            auto& q = *queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        ++pending;
+        ++pushes;
+
+        // only pay for a notification if a worker is (about to be) asleep
+        if(sleepers.load() > 0) {
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wakeup.notify_one();
+        }
+    }
+
+    /// Pops a task of the own queue or steals one from another queue;
+    /// skips the queues which are locked at the moment unless
+    /// wait_for_locks is set.
+    bool pop(size_t index, std::function<void()>& task, bool wait_for_locks) {
+        // the own queue first (oldest task first)...
+        {
+            auto& q = *queues[index];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if(!q.tasks.empty()) {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                --pending;
+                return true;
+            }
+        }
+
+        // ...then steal the newest task of another worker
+        for(size_t i = 1; i < queues.size(); ++i) {
+            auto& q = *queues[(index + i) % queues.size()];
+            std::unique_lock<std::mutex> lock(q.mutex, std::defer_lock);
+            if(wait_for_locks) {
+                lock.lock();
+            } else if(!lock.try_lock()) {
+                continue;
+            }
+            if(!q.tasks.empty()) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                --pending;
+                ++steals;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void run(size_t index) {
+        current()       = this;
+        current_index() = index;
+
+        const size_t max_spins = 64;
+
+        std::function<void()> task;
+        size_t spins = 0;
+        for(;;) {
+            if(pop(index, task, false)) {
+                spins = 0;
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            // a queued task whose queue was locked by someone else is
+            // likely to be available in a moment; retry a few times only
+            if((pending.load() > 0) && (++spins < max_spins)) {
+                std::this_thread::yield();
+                continue;
+            }
+            spins = 0;
+
+            // a final pass waiting for the locks finds every task queued
+            // before `seen`; all later ones change `pushes` and wake us up
+            auto seen = pushes.load();
+            if(pop(index, task, true)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            ++sleepers;
+            wakeup.wait(lock, [&]() { return ((pushes.load() != seen) || stop.load()); });
+            --sleepers;
+            if(stop.load() && (pending.load() == 0)) { break; }
+        }
+
+        current() = nullptr;
+    }
+};
+
+http::thread_pool::thread_pool(size_t thread_count) {
+    if(thread_count == 0) {
+        thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    m_state = std::make_shared<state>(thread_count);
+
+    // the workers keep the state alive; the last task of a pool might
+    // release the pool itself
+    auto s = m_state;
+    for(size_t i = 0; i < thread_count; ++i) {
+        m_state->workers.emplace_back([s, i]() { s->run(i); });
+    }
+}
+
+http::thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m_state->sleep_mutex);
+        m_state->stop = true;
+    }
+    m_state->wakeup.notify_all();
+
+    for(auto&& w : m_state->workers) {
+        if(w.get_id() == std::this_thread::get_id()) {
+            w.detach(); // destroyed from within one of its own tasks
+        } else {
+            w.join();
+        }
+    }
+}
+
+void http::thread_pool::post(std::function<void()> task) {
+    auto& s = *m_state;
+    auto index = ((state::current() == &s) ? state::current_index() : (s.next++ % s.queues.size()));
+    s.push(index, std::move(task));
+}
+
+size_t http::thread_pool::thread_count() const {
+    return m_state->queues.size();
+}
+
+size_t http::thread_pool::steal_count() const {
+    return m_state->steals.load();
+}
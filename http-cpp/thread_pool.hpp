@@ -0,0 +1,71 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+
+#include "./executor.hpp"
+
+#include <memory>
+
+ // disable warning: class 'ABC' needs to have dll-interface to be used by clients of struct 'XYZ'
+#if defined(_MSC_VER)
+#   pragma warning(push)
+#   pragma warning(disable: 4251)
+#endif // defined(_MSC_VER)
+
+namespace http {
+
+    /// A work-stealing pool of worker threads: each worker has its own
+    /// task queue (tasks posted from within a worker go to its own
+    /// queue, all others get distributed round-robin) and idle workers
+    /// steal tasks from the queues of the others. The destructor runs
+    /// all queued tasks before joining the workers.
+    struct HTTP_API thread_pool :
+        public executor
+    {
+        /// A thread_count of 0 uses the number of hardware threads.
+        explicit thread_pool(size_t thread_count = 0);
+        virtual ~thread_pool();
+
+        virtual void post(std::function<void()> task) override;
+
+        size_t thread_count() const;
+
+        /// Returns the number of tasks a worker took from the queue of
+        /// another worker so far.
+        size_t steal_count() const;
+
+    private:
+        struct state;
+        std::shared_ptr<state> m_state;
+
+    private:
+        thread_pool(thread_pool const&); // = delete;
+        thread_pool& operator=(thread_pool const&); // = delete;
+    };
+
+} // namespace http
+
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif // defined(_MSC_VER)
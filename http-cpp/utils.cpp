@@ -169,7 +169,7 @@ http::headers http::to_lower(
 ) {
     auto result = http::headers();
     for(auto&& h : hdrs) {
-        result[to_lower(h.first)] = h.second;
+        result.set(to_lower(h.first.str()), h.second);
     }
     return result;
 }
@@ -25,8 +25,17 @@
 
 #include <http-cpp/client.hpp>
 #include <http-cpp/requests.hpp>
+#include <http-cpp/thread_pool.hpp>
+#include <http-cpp/impl/rw_mutex.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <set>
+
+#if defined(__linux__)
+#   include <unistd.h>
+#endif // defined(__linux__)
 
 static bool contains(std::string const& str, std::string const& find) {
     return (str.find(find) != str.npos);
@@ -91,6 +100,20 @@ CUTE_TEST(
     CUTE_ASSERT(duration < 3); // should be clearly below the 3 seconds the web server will delay to answer the request
 }
 
+CUTE_TEST(
+    "Test canceling and resuming a finished request after its loop got replaced",
+    "[http],[request],[cancel],[localhost]"
+) {
+    auto request = http::client().request(LOCALHOST + "HTTP_200_OK");
+    check_result(request.data().get(), "URL found");
+
+    // the request must neither reach the destroyed loop nor change its result
+    http::client::configure(http::loop_options());
+    request.cancel();
+    request.resume();
+    check_result(request.data().get(), "URL found");
+}
+
 CUTE_TEST(
     "Test that the progress callback gets called during data transfer",
     "[http],[request],[progress],[localhost]"
@@ -548,3 +571,996 @@ CUTE_TEST(
     auto headers_received = data.headers;
     CUTE_ASSERT(headers_received.count("accept-encoding") == 0);
 }
+
+CUTE_TEST(
+    "Test requests running on the epoll loop engine",
+    "[http],[requests],[engine],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.engine = http::HTTP_LOOP_ENGINE_EPOLL;
+    http::client::configure(options);
+
+    perform_parallel_requests(10, LOCALHOST + "HTTP_200_OK", "URL found");
+
+    auto request = http::client().request(LOCALHOST + "delay");
+    request.cancel();
+    CUTE_ASSERT(request.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test requests distributed across multiple loops",
+    "[http],[requests],[loops],[localhost]"
+) {
+    const http::loop_policy policies[] = {
+        http::HTTP_LOOP_POLICY_HOST_HASH,
+        http::HTTP_LOOP_POLICY_LEAST_LOADED,
+        http::HTTP_LOOP_POLICY_ROUND_ROBIN
+    };
+
+    for(auto policy : policies) {
+        auto options = http::loop_options();
+        options.loop_count = 4;
+        options.policy = policy;
+        http::client::configure(options);
+
+        perform_parallel_requests(10, LOCALHOST + "HTTP_200_OK", "URL found");
+    }
+
+    std::atomic<size_t> select_called(0);
+    auto options = http::loop_options();
+    options.loop_count = 2;
+    options.select_loop = [&](std::string const&, std::vector<size_t> const& active) -> size_t {
+        CUTE_ASSERT(active.size() == 2);
+        ++select_called;
+        return 1;
+    };
+    http::client::configure(options);
+
+    perform_parallel_requests(10, LOCALHOST + "HTTP_200_OK", "URL found");
+    CUTE_ASSERT(select_called == 10);
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test waiting for all requests with a timeout",
+    "[http],[requests],[wait],[timeout],[localhost]"
+) {
+    auto request = http::client().request(LOCALHOST + "delay");
+    auto timed_out = (http::client::wait_for_all(std::chrono::milliseconds(100)) == std::future_status::timeout);
+    CUTE_ASSERT(timed_out);
+
+    http::client::cancel_all();
+    auto ready = (http::client::wait_until_all(std::chrono::system_clock::now() + std::chrono::seconds(1)) == std::future_status::ready);
+    CUTE_ASSERT(ready);
+    CUTE_ASSERT(request.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+}
+
+CUTE_TEST(
+    "Test that finished easy handles get reused by new requests",
+    "[http],[request],[pool],[localhost]"
+) {
+    http::client::configure(http::loop_options());
+
+    auto url = LOCALHOST + "HTTP_200_OK";
+    for(int i = 0; i < 5; ++i) {
+        check_result(http::client().request(url).data().get(), "URL found");
+        http::client::wait_for_all(); // ensure that the handle got released
+    }
+
+    auto stats = http::client::statistics();
+    CUTE_ASSERT(stats.easy_handle_pool_misses >= 1);
+    CUTE_ASSERT(stats.easy_handle_pool_hits >= 4);
+}
+
+CUTE_TEST(
+    "Test requests cloned from a client prototype handle",
+    "[http],[request],[prototype],[headers],[localhost]"
+) {
+    auto url = LOCALHOST + "echo_headers";
+
+    auto client = http::client();
+    client.use_prototype = true;
+    client.headers["http-cpp"] = "is cool";
+
+    for(int i = 0; i < 3; ++i) {
+        auto data = client.request(url).data().get();
+        check_result(data, "headers received");
+        CUTE_ASSERT(data.headers["http-cpp"] == "is cool");
+    }
+
+    // changing the configuration must rebuild the prototype
+    client.headers["http-cpp"] = "is still cool";
+    auto data = client.request(url).data().get();
+    check_result(data, "headers received");
+    CUTE_ASSERT(data.headers["http-cpp"] == "is still cool");
+
+    check_result(client.request(LOCALHOST + "HTTP_200_OK").data().get(), "URL found");
+}
+
+static size_t node_connections(int port) {
+    auto data = http::client().request(LOCALHOST + "connections?port=" + std::to_string(port)).data().get();
+    return std::stoul(std::string(data.body.begin(), data.body.end()));
+}
+
+CUTE_TEST(
+    "Test a GET request via HTTP/2 with prior knowledge (h2c)",
+    "[http],[request],[http2],[localhost]"
+) {
+    auto client = http::client();
+    client.protocol = http::HTTP_PROTOCOL_2_PRIOR_KNOWLEDGE;
+    check_result(client.request("http://localhost:8889/HTTP_200_OK").data().get(), "URL found");
+}
+
+#if defined(NODE_SERVER_CERT)
+
+CUTE_TEST(
+    "Test a GET request via HTTP/2 over TLS",
+    "[http],[request],[http2],[tls],[localhost]"
+) {
+    auto client = http::client();
+    client.protocol = http::HTTP_PROTOCOL_2_TLS;
+    client.ca_file  = NODE_SERVER_CERT;
+    check_result(client.request("https://localhost:8890/HTTP_200_OK").data().get(), "URL found");
+}
+
+CUTE_TEST(
+    "Test multiplexing parallel HTTP/2 requests over a single connection",
+    "[http],[requests],[http2],[multiplex],[tls],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.multiplex = true;
+    http::client::configure(options);
+
+    auto connections_before = node_connections(8890);
+
+    auto client = http::client();
+    client.protocol  = http::HTTP_PROTOCOL_2_TLS;
+    client.pipe_wait = true;
+    client.ca_file   = NODE_SERVER_CERT;
+
+    std::vector<http::request> requests;
+    for(int i = 0; i < 20; ++i) {
+        requests.push_back(client.request("https://localhost:8890/HTTP_200_OK"));
+    }
+    for(auto&& r : requests) {
+        check_result(r.data().get(), "URL found");
+    }
+
+    auto connections_opened = node_connections(8890) - connections_before;
+    CUTE_ASSERT(connections_opened == 1);
+
+    http::client::configure(http::loop_options());
+}
+
+#endif // defined(NODE_SERVER_CERT)
+
+CUTE_TEST(
+    "Test that the admission queue limits the number of active requests",
+    "[http],[requests],[admission],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.max_active_requests   = 2;
+    options.max_host_connections  = 2;
+    options.max_total_connections = 4;
+    http::client::configure(options);
+
+    auto url = LOCALHOST + "HTTP_200_OK";
+    std::vector<http::request> requests;
+    for(int i = 0; i < 10; ++i) {
+        requests.push_back(http::client().request(url));
+    }
+
+    size_t max_queue_depth = 0;
+    for(auto&& r : requests) {
+        check_result(r.data().get(), "URL found");
+        max_queue_depth = std::max(max_queue_depth, r.queue_depth());
+    }
+
+    // the first two requests get admitted immediately, the others wait
+    CUTE_ASSERT(requests[0].queue_depth() == 0);
+    CUTE_ASSERT(max_queue_depth >= 1);
+    CUTE_ASSERT(requests.back().queue_wait_time().count() > 0);
+    CUTE_ASSERT(http::client::statistics().queued_requests >= 1);
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test canceling requests waiting in the admission queue",
+    "[http],[requests],[admission],[cancel],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.max_active_requests = 1;
+    http::client::configure(options);
+
+    auto running = http::client().request(LOCALHOST + "delay");
+    auto queued1 = http::client().request(LOCALHOST + "HTTP_200_OK");
+    auto queued2 = http::client().request(LOCALHOST + "HTTP_200_OK");
+
+    queued1.cancel();
+    CUTE_ASSERT(queued1.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+
+    http::client::cancel_all();
+    CUTE_ASSERT(running.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+    CUTE_ASSERT(queued2.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test parallel requests from multiple loops sharing cookies, DNS, and TLS sessions",
+    "[http],[requests],[share],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.loop_count = 4;
+    options.policy     = http::HTTP_LOOP_POLICY_ROUND_ROBIN;
+    http::client::configure(options);
+
+    perform_parallel_requests(40, LOCALHOST + "HTTP_200_OK", "URL found");
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test that the share locks are held by several readers at once but by a single writer",
+    "[share],[lock]"
+) {
+    http::impl::rw_mutex lock;
+    CUTE_ASSERT(lock.try_lock_shared());
+
+    // another reader gets in while the first one still holds the lock
+    auto second_reader = false, writer = true;
+    std::thread([&]() {
+        second_reader = lock.try_lock_shared();
+        writer = lock.try_lock();
+        if(second_reader) { lock.unlock_any(); }
+    }).join();
+    CUTE_ASSERT(second_reader);
+    CUTE_ASSERT(!writer);
+
+    lock.unlock_any();
+    CUTE_ASSERT(lock.try_lock());
+
+    auto reader_while_writing = true;
+    std::thread([&]() {
+        reader_while_writing = lock.try_lock_shared();
+        if(reader_while_writing) { lock.unlock_shared(); }
+    }).join();
+    CUTE_ASSERT(!reader_while_writing);
+    lock.unlock_any();
+}
+
+CUTE_TEST(
+    "Test reusing connections across loops sharing their connection cache",
+    "[http],[requests],[share],[connections],[localhost]"
+) {
+    auto options = http::loop_options();
+    options.loop_count        = 4;
+    options.policy            = http::HTTP_LOOP_POLICY_ROUND_ROBIN;
+    options.share_connections = true;
+    http::client::configure(options);
+
+    auto url = LOCALHOST + "HTTP_200_OK";
+    for(int i = 0; i < 8; ++i) {
+        check_result(http::client().request(url).data().get(), "URL found");
+    }
+
+    // one connection for the first request, all others reuse it
+    auto stats = http::client::statistics();
+    CUTE_ASSERT(stats.new_connections == 1);
+    CUTE_ASSERT(stats.reused_connections == 7);
+
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test saving and preloading the session cache",
+    "[http],[request],[session_cache],[localhost]"
+) {
+    auto url = LOCALHOST + "HTTP_200_OK";
+    auto filename = std::string("session_cache.txt");
+    auto read_file = [&]() {
+        std::ifstream in(filename.c_str());
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    // the host addresses only get recorded on request
+    http::client::configure(http::loop_options());
+    check_result(http::client().request(url).data().get(), "URL found");
+    http::client::wait_for_all();
+    CUTE_ASSERT(http::client::save_session_cache(filename));
+    CUTE_ASSERT(!contains(read_file(), "dns localhost:8888 "));
+
+    auto options = http::loop_options();
+    options.record_session_hosts = true;
+    http::client::configure(options);
+    check_result(http::client().request(url).data().get(), "URL found");
+    http::client::wait_for_all(); // ensure the finished request got recorded
+    CUTE_ASSERT(http::client::save_session_cache(filename));
+    CUTE_ASSERT(contains(read_file(), "dns localhost:8888 "));
+
+    // simulate a restart with cold caches; loading while requests are
+    // already running is fine
+    http::client::configure(http::loop_options());
+    auto running = http::client().request(LOCALHOST + "stream");
+    CUTE_ASSERT(http::client::load_session_cache(filename));
+    CUTE_ASSERT(http::client::load_session_cache(filename));
+    CUTE_ASSERT(!http::client::load_session_cache("non-existing-session-cache.txt"));
+    CUTE_ASSERT(running.data().get().error_code == http::HTTP_ERROR_OK);
+
+    auto debug = std::string();
+    auto client = http::client();
+    client.on_debug = [&](std::string const& msg) { debug += msg; };
+    check_result(client.request(url).data().get(), "URL found");
+    CUTE_ASSERT(contains(debug, "Added localhost:8888:127.0.0.1 to DNS cache"));
+
+    std::remove(filename.c_str());
+    http::client::configure(http::loop_options());
+}
+
+CUTE_TEST(
+    "Test that http::headers copies share their content until modified",
+    "[http],[headers]"
+) {
+    http::headers a = { { "Content-Type", "text/plain" } };
+    http::headers b = a;
+    CUTE_ASSERT(a.begin()->second.data() == b.begin()->second.data());
+
+    b["X-Test"] = "1";
+    CUTE_ASSERT(a.begin()->second.data() != b.begin()->second.data());
+    CUTE_ASSERT(a.size() == 1);
+    CUTE_ASSERT(b.size() == 2);
+    CUTE_ASSERT(a.count("X-Test") == 0);
+    CUTE_ASSERT(b.at("Content-Type") == "text/plain");
+}
+
+CUTE_TEST(
+    "Test receiving a streamed response via the on_receive_view callback",
+    "[http],[receive_view],[stream],[localhost]"
+) {
+    std::string received;
+    std::string content_type;
+
+    auto client = http::client();
+    client.on_receive_view = [&](http::buffer_view data, http::headers const& headers, http::progress const&) {
+        received.append(data.begin(), data.end());
+        if(headers.count("content-type")) { content_type = headers.at("content-type").str(); }
+        return true;
+    };
+
+    auto reply = client.request(LOCALHOST + "stream").data().get();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(reply.status == http::HTTP_200_OK);
+    CUTE_ASSERT(reply.body.empty());
+
+    std::string expected;
+    for(int i = 0; i < 200; ++i) { expected += "streaming #" + std::to_string(i) + "\n"; }
+    CUTE_ASSERT(received == expected);
+    CUTE_ASSERT(content_type == "text/plain");
+}
+
+CUTE_TEST(
+    "Test that the body buffer gets reserved from the Content-Length of a response",
+    "[http],[body_reserve],[localhost]"
+) {
+    const size_t size = 1000000;
+    auto url = LOCALHOST + "large?size=" + std::to_string(size);
+
+    auto client = http::client();
+    auto reply = client.request(url).data().get();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(reply.body.size() == size);
+    CUTE_ASSERT(reply.body.capacity() < size + size / 100, CUTE_CAPTURE(reply.body.capacity()));
+
+    // a capped reservation still receives the whole body
+    client.max_body_reserve = 1000;
+    reply = client.request(url).data().get();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(reply.body.size() == size);
+}
+
+CUTE_TEST(
+    "Test http::segmented_buffer appending, iterating, and flattening",
+    "[http],[segmented_buffer]"
+) {
+    const size_t size = 3 * http::segmented_buffer::segment_size + 123;
+
+    std::string data;
+    for(size_t i = 0; i < size; ++i) { data += static_cast<char>('a' + (i % 26)); }
+
+    http::segmented_buffer buffer;
+    for(size_t pos = 0; pos < size; pos += 1000) {
+        buffer.append(data.data() + pos, std::min<size_t>(1000, size - pos));
+    }
+
+    CUTE_ASSERT(buffer.size() == size);
+    CUTE_ASSERT(buffer.segment_count() == 4);
+    CUTE_ASSERT(buffer.segment(3).size() == 123);
+    CUTE_ASSERT(buffer.flatten() == data);
+    CUTE_ASSERT(std::string(buffer.begin(), buffer.end()) == data);
+
+    auto copy = buffer;
+    buffer.clear();
+    CUTE_ASSERT(buffer.empty());
+    CUTE_ASSERT(copy.flatten() == data);
+    CUTE_ASSERT(http::segmented_buffer::pooled_segments() >= 4);
+}
+
+CUTE_TEST(
+    "Test receiving a response into a segmented body",
+    "[http],[segmented_buffer],[localhost]"
+) {
+    const size_t size = 1000000;
+
+    auto client = http::client();
+    client.segmented_body = true;
+
+    auto reply = client.request(LOCALHOST + "large?size=" + std::to_string(size)).data().get();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(reply.body.empty());
+    CUTE_ASSERT(reply.segmented_body.size() == size);
+    CUTE_ASSERT(reply.segmented_body.flatten() == std::string(size, 'x'));
+}
+
+CUTE_TEST(
+    "Test http::headers case-insensitive lookup and header line parsing",
+    "[http],[headers]"
+) {
+    http::headers h;
+    CUTE_ASSERT(h.parse_line("Content-Type: text/plain"));
+    CUTE_ASSERT(h.parse_line("X-Request-Id: 42"));
+    CUTE_ASSERT(h.parse_line("X-Custom-Field: a: b"));
+    CUTE_ASSERT(!h.parse_line("HTTP/1.1 200 OK"));
+
+    CUTE_ASSERT(h.size() == 3);
+    CUTE_ASSERT(h["content-type"] == "text/plain");
+    CUTE_ASSERT(h["CONTENT-TYPE"] == "text/plain");
+    CUTE_ASSERT(h.at("x-request-id") == "42");
+    CUTE_ASSERT(h.at("X-CUSTOM-FIELD") == "a: b");
+    CUTE_ASSERT(h.find("x-custom-field")->first == "x-custom-field");
+    CUTE_ASSERT(h.count("missing") == 0);
+    CUTE_ASSERT(static_cast<http::headers const&>(h)["missing"].empty());
+
+    h.set("content-type", "application/json");
+    CUTE_ASSERT(h["Content-Type"] == "application/json");
+    CUTE_ASSERT(h.size() == 3);
+    CUTE_ASSERT(h.erase("X-Request-Id") == 1);
+    CUTE_ASSERT(h.size() == 2);
+
+    // parsed names are lower case, set names keep their case (interned or not)
+    http::headers s = { { "Content-Type", "text/plain" }, { "X-Custom-Field", "a" } };
+    CUTE_ASSERT(h.begin()->first == "content-type");
+    CUTE_ASSERT(s.begin()->first == "Content-Type");
+    CUTE_ASSERT(s.find("x-custom-field")->first == "X-Custom-Field");
+    s.set("content-type", "text/html");
+    CUTE_ASSERT(s.begin()->first == "Content-Type");
+
+    // comparing ignores the order of the fields and the case of their names
+    http::headers r = { { "x-custom-field", "a" }, { "CONTENT-TYPE", "text/html" } };
+    auto equal = (s == r);
+    CUTE_ASSERT(equal);
+    r.set("X-Custom-Field", "A");
+    equal = (s == r);
+    CUTE_ASSERT(!equal);
+    r.set("X-Custom-Field", "a");
+    r.set("X-Other", "a");
+    equal = (s == r);
+    CUTE_ASSERT(!equal);
+    equal = (http::headers() == http::headers());
+    CUTE_ASSERT(equal);
+
+    // values set over and over again keep all fields intact while the
+    // unused text gets compacted
+    http::headers g = { { "Authorization", "token" }, { "X-Custom-Field", "a" }, { "Accept", "*/*" } };
+    for(int i = 0; i < 1000; ++i) {
+        g["Authorization"] = "Bearer " + std::string(static_cast<size_t>(i % 100), 't');
+        if(i % 10 == 0) { g.erase("Accept"); g.set("Accept", "text/" + std::to_string(i)); }
+    }
+    CUTE_ASSERT(g.size() == 3);
+    CUTE_ASSERT(g["authorization"] == ("Bearer " + std::string(99, 't')));
+    CUTE_ASSERT(g["x-custom-field"] == "a");
+    CUTE_ASSERT(g["accept"] == "text/990");
+    CUTE_ASSERT(g.find("x-custom-field")->first == "X-Custom-Field");
+
+    // well-known names are interned with distinct ids
+    CUTE_ASSERT(http::headers::interned_id("Content-Length") != 0);
+    CUTE_ASSERT(http::headers::interned_id("content-length") == http::headers::interned_id("CONTENT-LENGTH"));
+    CUTE_ASSERT(http::headers::interned_id("content-length") != http::headers::interned_id("content-type"));
+    CUTE_ASSERT(http::headers::interned_id("x-not-well-known") == 0);
+}
+
+namespace {
+    struct counting_memory_resource : http::memory_resource {
+        std::atomic<int> allocated;
+        std::atomic<int> deallocated;
+
+        counting_memory_resource() : allocated(0), deallocated(0) { }
+
+    protected:
+        virtual void* do_allocate(size_t bytes, size_t) override { ++allocated; return ::operator new(bytes); }
+        virtual void do_deallocate(void* p, size_t, size_t) override { ++deallocated; ::operator delete(p); }
+    };
+}
+
+CUTE_TEST(
+    "Test that the per-request arenas get allocated from and returned to the memory resource",
+    "[http],[arena],[localhost]"
+) {
+    auto resource = std::make_shared<counting_memory_resource>();
+
+    auto client = http::client();
+    client.memory_resource = resource;
+
+    for(auto arena_size : { size_t(2048), size_t(1) }) { // the tiny arena needs additional blocks
+        client.request_arena_size = arena_size;
+        bool finished = false;
+        client.on_finish = [&](http::request req) { finished = (req.data().get().status == http::HTTP_200_OK); };
+        {
+            auto request = client.request(LOCALHOST + "HTTP_200_OK");
+            check_result(request.data().get(), "URL found");
+        }
+        http::client::wait_for_all();
+        CUTE_ASSERT(finished);
+    }
+
+    CUTE_ASSERT(resource->allocated >= 3);
+    CUTE_ASSERT(resource->allocated == resource->deallocated);
+}
+
+CUTE_TEST(
+    "Test waiting for a request and accessing its result with and without a future",
+    "[http],[completion],[localhost]"
+) {
+    auto client = http::client();
+
+    auto delayed = client.request(LOCALHOST + "delay");
+    CUTE_ASSERT(!delayed.ready());
+    auto timed_out = (delayed.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+    CUTE_ASSERT(timed_out);
+    delayed.cancel();
+    CUTE_ASSERT(delayed.result().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+
+    // the future gets created after the request finished already
+    auto req = client.request(LOCALHOST + "HTTP_200_OK");
+    auto ready = (req.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CUTE_ASSERT(ready);
+    CUTE_ASSERT(req.ready());
+    check_result(req.result(), "URL found");
+    check_result(req.data().get(), "URL found");
+    check_result(req.result(), "URL found");
+
+    // without an outstanding reference the message moves into the future
+    req = client.request(LOCALHOST + "HTTP_200_OK");
+    req.wait();
+    check_result(req.data().get(), "URL found");
+    auto shared = (&req.result() == &req.data().get());
+    CUTE_ASSERT(shared);
+
+    // the future gets created before the request finishes
+    req = client.request(LOCALHOST + "HTTP_200_OK");
+    auto future = req.data();
+    check_result(req.result(), "URL found");
+    check_result(future.get(), "URL found");
+}
+
+CUTE_TEST(
+    "Test harvesting finished requests from a completion queue",
+    "[http],[completion],[localhost]"
+) {
+    auto queue = std::make_shared<http::completion_queue>(4);
+    auto client = http::client();
+    client.completion_queue = queue;
+
+    auto requests = std::vector<http::request>();
+    for(auto i = 0; i < 10; ++i) {
+        requests.push_back(client.request(LOCALHOST + ((i % 2) ? "HTTP_200_OK" : "HTTP_404_NOT_FOUND")));
+    }
+    requests.clear();
+
+    // nothing gets lost even though the ring is smaller than the number of requests
+    auto finished = std::vector<http::request>(3);
+    auto harvested = size_t(0);
+    auto ok = size_t(0);
+    while(harvested < 10) {
+        auto n = queue->pop_wait_for(finished.data(), finished.size(), std::chrono::seconds(10));
+        CUTE_ASSERT(n > 0);
+        CUTE_ASSERT(n <= finished.size());
+        for(size_t i = 0; i < n; ++i) {
+            CUTE_ASSERT(finished[i].ready());
+            if(finished[i].result().status == http::HTTP_200_OK) { ++ok; }
+        }
+        harvested += n;
+    }
+    CUTE_ASSERT(ok == 5);
+    CUTE_ASSERT(queue->size() == 0);
+    CUTE_ASSERT(queue->pop(finished.data(), finished.size()) == 0);
+
+    // waiting on an empty queue times out
+    auto n = queue->pop_wait_for(finished.data(), finished.size(), std::chrono::milliseconds(50));
+    CUTE_ASSERT(n == 0);
+}
+
+CUTE_TEST(
+    "Test that the tasks of a strand on a thread pool run one after the other in order",
+    "[http],[executor]"
+) {
+    auto pool = std::make_shared<http::thread_pool>(4);
+    CUTE_ASSERT(pool->thread_count() == 4);
+
+    http::strand strand(pool);
+    const int count = 10000;
+    std::vector<int> order;
+    std::atomic<int> running(0);
+    std::atomic<bool> overlapped(false);
+    std::atomic<int> done(0);
+    for(int i = 0; i < count; ++i) {
+        // some independent tasks in between to keep the other workers busy
+        pool->post([&]() { ++done; });
+        strand.post([&, i]() {
+            if(++running > 1) { overlapped = true; }
+            order.push_back(i);
+            --running;
+            ++done;
+        });
+    }
+    while(done < 2 * count) { std::this_thread::yield(); }
+
+    CUTE_ASSERT(!overlapped);
+    CUTE_ASSERT(order.size() == static_cast<size_t>(count));
+    for(int i = 0; i < count; ++i) { CUTE_ASSERT(order[i] == i); }
+}
+
+CUTE_TEST(
+    "Test running the callbacks of requests on a callback executor",
+    "[http],[executor],[stream],[localhost]"
+) {
+    auto pool = std::make_shared<http::thread_pool>(2);
+    std::mutex mutex;
+    std::string received_view;
+    std::string received;
+    std::atomic<int> finished(0);
+    std::set<std::thread::id> callback_threads;
+
+    auto client = http::client();
+    client.callback_executor = pool;
+
+    client.on_receive_view = [&](http::buffer_view data, http::headers const&, http::progress const&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received_view.append(data.begin(), data.end());
+        callback_threads.insert(std::this_thread::get_id());
+        return true;
+    };
+    client.on_finish = [&](http::request req) {
+        CUTE_ASSERT(req.result().error_code == http::HTTP_ERROR_OK);
+        ++finished;
+    };
+    auto req1 = client.request(LOCALHOST + "stream");
+
+    client.on_receive = [&](http::message msg, http::progress) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.append(msg.body.begin(), msg.body.end());
+        callback_threads.insert(std::this_thread::get_id());
+        return true;
+    };
+    client.on_finish = [&](http::request) { ++finished; };
+    auto req2 = client.request(LOCALHOST + "stream");
+
+    // waiting for all requests includes their offloaded callbacks
+    http::client::wait_for_all();
+    CUTE_ASSERT(finished == 2);
+    CUTE_ASSERT(req1.ready());
+    CUTE_ASSERT(req2.ready());
+
+    std::string expected;
+    for(int i = 0; i < 200; ++i) { expected += "streaming #" + std::to_string(i) + "\n"; }
+    CUTE_ASSERT(received_view == expected);
+    CUTE_ASSERT(received == expected);
+    CUTE_ASSERT(!callback_threads.count(std::this_thread::get_id()));
+}
+
+CUTE_TEST(
+    "Test that a slow callback on a callback executor does not stall other requests",
+    "[http],[executor],[localhost]"
+) {
+    auto client = http::client();
+    client.callback_executor = std::make_shared<http::thread_pool>(2);
+
+    std::atomic<bool> sleeping(false);
+    client.on_finish = [&](http::request) {
+        sleeping = true;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    };
+    auto slow = client.request(LOCALHOST + "HTTP_200_OK");
+    while(!sleeping) { std::this_thread::yield(); }
+
+    auto start = std::chrono::steady_clock::now();
+    auto fast = client.request(LOCALHOST + "HTTP_200_OK");
+    check_result(fast.data().get(), "URL found");
+    auto fast_enough = ((std::chrono::steady_clock::now() - start) < std::chrono::milliseconds(500));
+    CUTE_ASSERT(fast_enough);
+
+    // the canceling return value of a callback still works (a large
+    // response keeps the transfer from finishing ahead of the cancelation)
+    client.on_receive = [&](http::message, http::progress) { return false; };
+    auto canceled = client.request(LOCALHOST + "large?size=" + std::to_string(64 * 1024 * 1024));
+    CUTE_ASSERT(canceled.data().get().error_code == http::HTTP_ERROR_REQUEST_CANCELED);
+
+    check_result(slow.data().get(), "URL found");
+}
+
+namespace {
+
+    /// Queues the posted tasks until the owner runs them.
+    struct manual_executor :
+        public http::executor
+    {
+        virtual void post(std::function<void()> task) override {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+
+        bool run_one() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(m_tasks.empty()) { return false; }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+
+    private:
+        std::mutex                          m_mutex;
+        std::deque<std::function<void()>>   m_tasks;
+    };
+
+} // namespace
+
+CUTE_TEST(
+    "Test that progress updates for a stalled callback executor get coalesced",
+    "[http],[executor],[localhost]"
+) {
+    const size_t size = 8 * 1024 * 1024;
+
+    auto executor = std::make_shared<manual_executor>();
+    auto client = http::client();
+    client.callback_executor = executor;
+
+    size_t calls = 0;
+    http::progress last;
+    client.on_progress = [&](http::progress p) { ++calls; last = p; return true; };
+
+    // let the whole transfer happen before running any callback
+    auto req = client.request(LOCALHOST + "large?size=" + std::to_string(size));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while((req.progress().downloadCurrentBytes < size) && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    while(!req.ready()) {
+        if(!executor->run_one()) { std::this_thread::yield(); }
+    }
+    while(executor->run_one()) { }
+
+    CUTE_ASSERT(req.result().error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(last.downloadCurrentBytes == size);
+    CUTE_ASSERT(calls < 10, CUTE_CAPTURE(calls)); // one per libcurl tick without coalescing
+}
+
+static size_t resident_bytes() {
+#if defined(__linux__)
+    size_t pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if(statm >> pages >> resident) {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif // defined(__linux__)
+    return 0;
+}
+
+CUTE_TEST(
+    "Test that a slow consumer on a callback executor pauses the transfer instead of buffering",
+    "[http],[executor],[flow_control],[localhost]"
+) {
+    const size_t size = 512 * 1024 * 1024;
+    const size_t limit = 1024 * 1024;
+
+    auto client = http::client();
+    client.callback_executor = std::make_shared<http::thread_pool>(1);
+    client.receive_buffer_limit = limit;
+
+    auto rss_before = resident_bytes();
+    auto rss_max = rss_before;
+    size_t received = 0;
+    size_t since_sleep = 0;
+    client.on_receive_view = [&](http::buffer_view data, http::headers const&, http::progress const&) {
+        received += data.size();
+        since_sleep += data.size();
+        if(since_sleep >= 256 * 1024) {
+            // a consumer slower than the local network
+            since_sleep = 0;
+            rss_max = std::max(rss_max, resident_bytes());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+
+    auto resumed_before = http::client::statistics().resumed_transfers;
+    auto reply = client.request(LOCALHOST + "large?size=" + std::to_string(size)).data().get();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(received == size);
+    CUTE_ASSERT(http::client::statistics().resumed_transfers > resumed_before);
+
+    // the queued data stays within the limit (plus the buffers of libcurl)
+    CUTE_ASSERT(rss_max - rss_before < 32 * 1024 * 1024, CUTE_CAPTURE(rss_max - rss_before));
+}
+
+CUTE_TEST(
+    "Test reading a large body incrementally from a body_stream",
+    "[http],[body_stream],[flow_control],[localhost]"
+) {
+    const size_t size = 32 * 1024 * 1024;
+
+    auto client = http::client();
+    client.body_stream_size = 256 * 1024;
+
+    auto resumed_before = http::client::statistics().resumed_transfers;
+    auto req = client.request(LOCALHOST + "large?size=" + std::to_string(size));
+    auto stream = req.stream();
+    CUTE_ASSERT(stream.valid());
+
+    std::vector<char> chunk(10000);
+    size_t received = 0;
+    auto all_x = true;
+    while(auto n = stream.read(chunk.data(), chunk.size())) {
+        all_x = all_x && std::all_of(chunk.begin(), chunk.begin() + n, [](char c) { return (c == 'x'); });
+        received += n;
+        if(received % (1024 * 1024) < chunk.size()) {
+            // a slow reader lets the buffer run full
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    CUTE_ASSERT(stream.eof());
+    CUTE_ASSERT(received == size);
+    CUTE_ASSERT(all_x);
+    CUTE_ASSERT(http::client::statistics().resumed_transfers > resumed_before);
+
+    auto const& reply = req.result();
+    CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(reply.status == http::HTTP_200_OK);
+    CUTE_ASSERT(reply.body.empty());
+
+    // a request without a body stream
+    client.body_stream_size = 0;
+    CUTE_ASSERT(!client.request(LOCALHOST + "HTTP_200_OK").stream().valid());
+}
+
+CUTE_TEST(
+    "Test reading a body_stream asynchronously and dropping an unread one",
+    "[http],[body_stream],[localhost]"
+) {
+    auto client = http::client();
+    client.body_stream_size = 1;
+
+    struct async_reader {
+        http::body_stream       stream;
+        char                    chunk[100];
+        std::string             received;
+        std::atomic<bool>       done;
+
+        void start() {
+            stream.async_read(chunk, sizeof(chunk), [this](size_t n) {
+                if(n == 0) { done = true; return; }
+                received.append(chunk, n);
+                start();
+            });
+        }
+    };
+
+    async_reader reader;
+    reader.done = false;
+    auto req = client.request(LOCALHOST + "stream");
+    reader.stream = req.stream();
+    reader.start();
+    while(!reader.done) { std::this_thread::yield(); }
+
+    std::string expected;
+    for(int i = 0; i < 200; ++i) { expected += "streaming #" + std::to_string(i) + "\n"; }
+    CUTE_ASSERT(reader.received == expected);
+    CUTE_ASSERT(req.result().error_code == http::HTTP_ERROR_OK);
+
+    // the transfer finishes once the only reader is gone
+    auto unread = client.request(LOCALHOST + "large?size=" + std::to_string(8 * 1024 * 1024));
+    unread.stream();
+    CUTE_ASSERT(unread.result().error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(!unread.stream().read_for(reader.chunk, sizeof(reader.chunk), std::chrono::seconds(1)));
+}
+
+CUTE_TEST(
+    "Test that a body_stream which never gets read does not stall the request",
+    "[http],[body_stream],[flow_control],[localhost]"
+) {
+    auto client = http::client();
+    client.body_stream_size = 64 * 1024;
+
+    // neither a reader nor a request handle to obtain one later
+    client.request(LOCALHOST + "large?size=" + std::to_string(8 * 1024 * 1024));
+    auto all_finished = (http::client::wait_for_all(std::chrono::seconds(10)) == std::future_status::ready);
+    CUTE_ASSERT(all_finished);
+
+    auto req = client.request(LOCALHOST + "large?size=" + std::to_string(8 * 1024 * 1024));
+    auto ready = (req.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CUTE_ASSERT(ready);
+    CUTE_ASSERT(req.result().error_code == http::HTTP_ERROR_OK);
+    CUTE_ASSERT(req.result().body.empty());
+
+    // a late reader finds the discarded body at its end
+    char chunk[1024];
+    auto stream = req.stream();
+    CUTE_ASSERT(stream.read(chunk, sizeof(chunk)) == 0);
+    CUTE_ASSERT(stream.eof());
+}
+
+static size_t count_x_in_file(std::string const& filename, size_t& size) {
+    std::ifstream in(filename, std::ios::binary);
+    std::vector<char> chunk(64 * 1024);
+    size_t count = 0;
+    size = 0;
+    while(in.read(chunk.data(), chunk.size()) || in.gcount()) {
+        auto n = static_cast<size_t>(in.gcount());
+        count += static_cast<size_t>(std::count(chunk.begin(), chunk.begin() + n, 'x'));
+        size += n;
+    }
+    return count;
+}
+
+CUTE_TEST(
+    "Test writing a receive file from the writer threads with all file sink options",
+    "[http],[file_sink],[localhost]"
+) {
+    const size_t size = 8 * 1024 * 1024 + 12345; // not a multiple of the block size
+    auto filename = cute::temp_folder() + "receive_file_sink.bin";
+
+    for(auto direct_io : { false, true }) {
+        auto client = http::client();
+        client.receive_file = filename;
+        client.receive_file_options.async = true;
+        client.receive_file_options.buffer_size = 64 * 1024;
+        client.receive_file_options.max_pending_buffers = 1; // lets the transfer pause
+        client.receive_file_options.preallocate = true;
+        client.receive_file_options.direct_io = direct_io;
+        client.receive_file_options.durable = true;
+
+        auto reply = client.request(LOCALHOST + "large?size=" + std::to_string(size)).result();
+        CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_OK);
+        CUTE_ASSERT(reply.body.empty());
+
+        // the data is completely written once the request finished
+        size_t file_size = 0;
+        CUTE_ASSERT(count_x_in_file(filename, file_size) == size);
+        CUTE_ASSERT(file_size == size);
+    }
+
+    std::remove(filename.c_str());
+}
+
+#if defined(__linux__)
+CUTE_TEST(
+    "Test that a failing write to a receive file aborts the transfer",
+    "[http],[file_sink],[localhost]"
+) {
+    for(auto async : { false, true }) {
+        auto client = http::client();
+        client.receive_file = "/dev/full";
+        client.receive_file_options.async = async;
+
+        auto reply = client.request(LOCALHOST + "large?size=" + std::to_string(16 * 1024 * 1024)).result();
+        CUTE_ASSERT(reply.error_code == http::HTTP_ERROR_WRITE_ERROR, CUTE_CAPTURE(http::to_string(reply.error_code)));
+    }
+}
+#endif // defined(__linux__)
@@ -0,0 +1,204 @@
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2013-2014 by Konstantin (Kosta) Baumann & Autodesk Inc.
+//
+// Permission is hereby granted, free of charge,  to any person obtaining a copy of
+// this software and  associated documentation  files  (the "Software"), to deal in
+// the  Software  without  restriction,  including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software,  and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this  permission notice  shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE  SOFTWARE  IS  PROVIDED  "AS IS",  WITHOUT  WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE  AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE  LIABLE FOR ANY CLAIM,  DAMAGES OR OTHER LIABILITY, WHETHER
+// IN  AN  ACTION  OF  CONTRACT,  TORT  OR  OTHERWISE,  ARISING  FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include <cute/cute.hpp>
+
+#include <http-cpp/client.hpp>
+#include <http-cpp/coroutine.hpp>
+
+#if defined(HTTP_CPP_HAS_COROUTINES)
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+static const std::string LOCALHOST = "http://localhost:8888/";
+
+// replaces the global allocation functions in order to count the heap
+// allocations of a single thread; all other forms of operator new/delete
+// forward to these
+
+static thread_local size_t t_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++t_allocations;
+    if(auto ptr = std::malloc(size ? size : 1)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) HTTP_CPP_NOEXCEPT {
+    std::free(ptr);
+}
+
+namespace {
+
+    /// A coroutine which starts right away and signals its end.
+    struct detached_task {
+        struct promise_type {
+            detached_task get_return_object() { return detached_task(); }
+            std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+            std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+            void return_void() { }
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    /// Runs posted coroutine handles on a thread of its own.
+    struct thread_executor {
+        thread_executor() : m_stop(false), m_thread([this]() { run(); }) { }
+
+        ~thread_executor() {
+            { std::lock_guard<std::mutex> lock(m_mutex); m_stop = true; }
+            m_cv.notify_one();
+            m_thread.join();
+        }
+
+        void post(std::coroutine_handle<> handle) {
+            { std::lock_guard<std::mutex> lock(m_mutex); m_queue.push_back(handle); }
+            m_cv.notify_one();
+        }
+
+        std::thread::id id() const { return m_thread.get_id(); }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for(;;) {
+                m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+                if(m_queue.empty()) { return; }
+                auto handle = m_queue.front();
+                m_queue.pop_front();
+                lock.unlock();
+                handle.resume();
+                lock.lock();
+            }
+        }
+
+        std::mutex                          m_mutex;
+        std::condition_variable             m_cv;
+        std::deque<std::coroutine_handle<>> m_queue;
+        bool                                m_stop;
+        std::thread                         m_thread;
+    };
+
+    detached_task await_sequential_requests(int count, std::atomic<int>& succeeded, std::atomic<bool>& done) {
+        auto client = http::client();
+        for(int i = 0; i < count; ++i) {
+            auto req = client.request(LOCALHOST + "HTTP_200_OK");
+            auto const& reply = co_await req;
+            if((reply.status == http::HTTP_200_OK) && (reply.body == "URL found")) { ++succeeded; }
+        }
+
+        // awaiting a temporary request object results in its message
+        auto reply = co_await client.request(LOCALHOST + "HTTP_404_NOT_FOUND");
+        if(reply.status == http::HTTP_404_NOT_FOUND) { ++succeeded; }
+
+        done = true;
+    }
+
+    detached_task await_on_executor(thread_executor& executor, std::atomic<bool>& resumed_on_executor, std::atomic<bool>& done) {
+        auto client = http::client();
+        auto req = client.request(LOCALHOST + "HTTP_200_OK");
+        auto const& reply = co_await http::resume_on(executor, req);
+        resumed_on_executor = ((reply.status == http::HTTP_200_OK) && (std::this_thread::get_id() == executor.id()));
+        done = true;
+    }
+
+    /// Forwards to another awaiter and counts the allocations done by
+    /// its await_resume() on the resuming thread.
+    template<typename AWAITER>
+    struct counting_awaiter {
+        counting_awaiter(AWAITER& awaiter, size_t& allocations) : m_awaiter(awaiter), m_allocations(allocations) { }
+
+        bool await_ready() { return m_awaiter.await_ready(); }
+        auto await_suspend(std::coroutine_handle<> handle) { return m_awaiter.await_suspend(handle); }
+
+        auto await_resume() {
+            auto before = t_allocations;
+            auto result = m_awaiter.await_resume();
+            m_allocations = t_allocations - before;
+            return result;
+        }
+
+    private:
+        AWAITER&    m_awaiter;
+        size_t&     m_allocations;
+    };
+
+    detached_task await_large_temporary(size_t size, std::atomic<bool>& received, size_t& allocations, std::atomic<bool>& done) {
+        auto client = http::client();
+        auto awaiter = operator co_await(client.request(LOCALHOST + "large?size=" + std::to_string(size)));
+        auto reply = co_await counting_awaiter<decltype(awaiter)>(awaiter, allocations);
+        received = ((reply.status == http::HTTP_200_OK) && (reply.body.size() == size));
+        done = true;
+    }
+
+} // namespace
+
+CUTE_TEST(
+    "Test awaiting requests from a coroutine",
+    "[http],[coroutine],[localhost]"
+) {
+    std::atomic<int> succeeded(0);
+    std::atomic<bool> done(false);
+    await_sequential_requests(10, succeeded, done);
+
+    while(!done) { std::this_thread::yield(); }
+    CUTE_ASSERT(succeeded == 11);
+    http::client::wait_for_all();
+}
+
+CUTE_TEST(
+    "Test resuming an awaiting coroutine via an executor",
+    "[http],[coroutine],[localhost]"
+) {
+    thread_executor executor;
+    std::atomic<bool> resumed_on_executor(false);
+    std::atomic<bool> done(false);
+    await_on_executor(executor, resumed_on_executor, done);
+
+    while(!done) { std::this_thread::yield(); }
+    CUTE_ASSERT(resumed_on_executor);
+    http::client::wait_for_all();
+}
+
+CUTE_TEST(
+    "Test that awaiting a temporary request moves its message out",
+    "[http],[coroutine],[localhost]"
+) {
+    std::atomic<bool> received(false);
+    std::atomic<bool> done(false);
+    size_t allocations = size_t(-1);
+    await_large_temporary(1024 * 1024, received, allocations, done);
+
+    while(!done) { std::this_thread::yield(); }
+    CUTE_ASSERT(received);
+    CUTE_ASSERT(allocations == 0); // a copy would allocate the body again
+    http::client::wait_for_all();
+}
+
+#endif // defined(HTTP_CPP_HAS_COROUTINES)
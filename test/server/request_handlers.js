@@ -36,6 +36,21 @@ function register_handlers(handle) {
         response.end();
     }
 
+    handle["/large"] = function (request, response) {
+        var size = parseInt(require("url").parse(request.url, true).query.size || "16777216", 10);
+        var chunk = Buffer.alloc(65536, "x");
+        response.writeHead(200, { "Content-Type": "application/octet-stream", "Content-Length": size });
+        var write_chunks = function () {
+            while (size > 0) {
+                var part = (size < chunk.length ? chunk.slice(0, size) : chunk);
+                size -= part.length;
+                if (!response.write(part)) { response.once("drain", write_chunks); return; }
+            }
+            response.end();
+        };
+        write_chunks();
+    }
+
     handle["/delay"] = function (request, response) {
         setTimeout(function () {
             response.writeHead(200, { "Content-Type": "text/plain" });
@@ -44,6 +59,14 @@ function register_handlers(handle) {
         }, 3000); // wait 3 second before responding
     }
 
+    handle["/long_poll"] = function (request, response) {
+        setTimeout(function () {
+            response.writeHead(200, { "Content-Type": "text/plain" });
+            response.write("long poll finished");
+            response.end();
+        }, 30000); // hold the connection open for 30 seconds
+    }
+
     handle["/echo_headers"] = function (request, response) {
         var headers = request.headers;
         headers["Content-Type"] = "text/plain";
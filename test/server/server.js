@@ -1,7 +1,11 @@
+var fs = require("fs");
 var http = require("http");
+var path = require("path");
 var url = require("url");
 
 function start(route, handle) {
+	var connections = { };
+
 	function onRequest(request, response) {
 		var pathname = url.parse(request.url).pathname;
 //		console.log("Request for " + pathname + " received.");
@@ -9,8 +13,39 @@ function start(route, handle) {
 		route(handle, pathname, request, response);
 	}
 
-	http.createServer(onRequest).listen(8888);
+	function onConnection(socket) {
+		connections[socket.localPort] = (connections[socket.localPort] || 0) + 1;
+	}
+
+	// reports the number of connections accepted so far on the given port
+	handle["/connections"] = function (request, response) {
+		var port = url.parse(request.url, true).query.port || 8888;
+		var msg = "" + (connections[port] || 0);
+		response.writeHead(200, { "Content-Type": "text/plain", "Content-Length": msg.length });
+		response.write(msg);
+		response.end();
+	}
+
+	http.createServer(onRequest).on("connection", onConnection).listen(8888);
 	console.log("Local node.js server has been started on port 8888.");
+
+	// HTTP/2 without TLS (h2c) for clients using prior knowledge
+	try {
+		var http2 = require("http2");
+		http2.createServer(onRequest).on("connection", onConnection).listen(8889);
+		console.log("Local node.js h2c server has been started on port 8889.");
+
+		// HTTP/2 via TLS/ALPN with a self-signed certificate; falls back to HTTP/1.1
+		http2.createSecureServer({
+			key:         fs.readFileSync(path.join(__dirname, "localhost.key")),
+			cert:        fs.readFileSync(path.join(__dirname, "localhost.crt")),
+			allowHTTP1:  true,
+			settings:    { maxConcurrentStreams: 1000 }
+		}, onRequest).on("connection", onConnection).listen(8890);
+		console.log("Local node.js h2 server has been started on port 8890.");
+	} catch (e) {
+		console.log("No HTTP/2 server available: " + e);
+	}
 }
 
 exports.start = start;